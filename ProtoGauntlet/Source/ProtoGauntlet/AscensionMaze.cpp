@@ -3,13 +3,17 @@
 #include "ProtoGauntlet.h"
 #include "AscensionMaze.h"
 
-void AAscensionMaze::CreateMazeLayout() {
-	FMazeRowData WallRow;
+AAscensionMaze::AAscensionMaze() {
+	// The layers are solid blocks over an all-path grid.
+	bOpenLayoutHint = true;
+	LayerStepInterval = 2.1f;
 
-	WallRow.Column.Init(ETileDesignation::TD_Path, MazeLengthInTiles);
-	for (int32 index = 0; index < MazeLengthInTiles; index++) {
-		Row.Add(WallRow);
-	}
+	WallSequencer = CreateDefaultSubobject<UMazeWallSequencer>(TEXT("WallSequencer"));
+	WallSequencer->bReenableWalls = true;
+}
+
+void AAscensionMaze::CreateMazeLayout(FMazeTileGrid& Target) {
+	Target.Init(MazeLengthInTiles, MazeLengthInTiles, ETileDesignation::TD_Path);
 
 }
 
@@ -17,8 +21,11 @@ void AAscensionMaze::BeginPlay() {
 	Super::BeginPlay();
 
 	PathfindingActive = false;
-	FTimerHandle LayerTimer;
-	GetWorldTimerManager().SetTimer(LayerTimer, this, &AAscensionMaze::Descend, 0.1f, false);
+	WallSequencer->OnMarker = [this](int32 Level) {
+		LevelOfAscension = Level;
+	};
+	CompileSequence();
+	WallSequencer->Play();
 
 }
 
@@ -30,6 +37,10 @@ void AAscensionMaze::SpawnFloor() {
 
 }
 
+bool AAscensionMaze::SupportsWallStreaming() const {
+	return false;
+}
+
 void AAscensionMaze::SpawnWalls() {
 	NumberOfLayers = (MazeLengthInTiles - 9) / 8 + 1;
 	NumberOfAscensions = NumberOfLayers * 2 - 2;
@@ -40,101 +51,112 @@ void AAscensionMaze::SpawnWalls() {
 	WestWalls.SetNum(0);
 
 	for (int32 Layer = 1; Layer < NumberOfLayers; Layer++) {
-		EastWalls.Emplace(Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass)));
-		EastWalls[Layer - 1]->SetActorLocation(GetActorLocation() + FVector((float)(MazeLengthInTiles - 4 * (Layer)) * TileSize, (4 * (Layer - 1)) * TileSize, 0.f));
-		EastWalls[Layer - 1]->SetActorScale3D(FVector( 4.f * TileSize / 100.f, (float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, InnerWallHeight / 100.f));
+		EastWalls.Emplace(SpawnSpanningWall(FVector((float)(MazeLengthInTiles - 4 * (Layer)) * TileSize, (4 * (Layer - 1)) * TileSize, 0.f), FVector( 4.f * TileSize / 100.f, (float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, InnerWallHeight / 100.f)));
 
-		NorthWalls.Emplace(Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass)));
-		NorthWalls[Layer - 1]->SetActorLocation(GetActorLocation() + FVector((4 * (Layer - 1)) * TileSize, (4 * (Layer - 1)) * TileSize, 0.f));
-		NorthWalls[Layer - 1]->SetActorScale3D(FVector((float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, 4.f * TileSize / 100.f, InnerWallHeight / 100.f));
+		NorthWalls.Emplace(SpawnSpanningWall(FVector((4 * (Layer - 1)) * TileSize, (4 * (Layer - 1)) * TileSize, 0.f), FVector((float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, 4.f * TileSize / 100.f, InnerWallHeight / 100.f)));
 
-		SouthWalls.Emplace(Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass)));
-		SouthWalls[Layer - 1]->SetActorLocation(GetActorLocation() + FVector((4 * (Layer - 1)) * TileSize, (float)(MazeLengthInTiles - 4 * (Layer)) * TileSize, 0.f));
-		SouthWalls[Layer - 1]->SetActorScale3D(FVector((float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, 4.f * TileSize / 100.f, InnerWallHeight / 100.f));
+		SouthWalls.Emplace(SpawnSpanningWall(FVector((4 * (Layer - 1)) * TileSize, (float)(MazeLengthInTiles - 4 * (Layer)) * TileSize, 0.f), FVector((float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, 4.f * TileSize / 100.f, InnerWallHeight / 100.f)));
 		
-		WestWalls.Emplace(Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass)));
-		WestWalls[Layer - 1]->SetActorLocation(GetActorLocation() + FVector((float)(4 * (Layer - 1)) * TileSize, (4 * (Layer - 1)) * TileSize, 0.f));
-		WestWalls[Layer - 1]->SetActorScale3D(FVector(4.f * TileSize / 100.f, (float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, InnerWallHeight / 100.f));
+		WestWalls.Emplace(SpawnSpanningWall(FVector((float)(4 * (Layer - 1)) * TileSize, (4 * (Layer - 1)) * TileSize, 0.f), FVector(4.f * TileSize / 100.f, (float)(MazeLengthInTiles - 8 * (Layer - 1))* TileSize / 100.f, InnerWallHeight / 100.f)));
 		
 	}
 
-	Centerpiece = Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass));
-	Centerpiece->SetActorLocation(GetActorLocation() + FVector((4 * (NumberOfLayers - 1)) * TileSize, (4 * (NumberOfLayers - 1)) * TileSize, 0.f));
-	Centerpiece->SetActorScale3D(FVector((float)(MazeLengthInTiles - 8 * (NumberOfLayers - 1))* TileSize / 100.f, (float)(MazeLengthInTiles - 8 * (NumberOfLayers - 1))* TileSize / 100.f, InnerWallHeight / 100.f));
+	Centerpiece = SpawnSpanningWall(FVector((4 * (NumberOfLayers - 1)) * TileSize, (4 * (NumberOfLayers - 1)) * TileSize, 0.f), FVector((float)(MazeLengthInTiles - 8 * (NumberOfLayers - 1))* TileSize / 100.f, (float)(MazeLengthInTiles - 8 * (NumberOfLayers - 1))* TileSize / 100.f, InnerWallHeight / 100.f));
+
+	WallSequencer->ResetTimeline();
+	LayerSets.SetNum(0);
+	for (int32 Layer = 0; Layer < NumberOfLayers - 1; Layer++) {
+		TArray<AMazeWall*> LayerWalls;
+		LayerWalls.Add(EastWalls[Layer]);
+		LayerWalls.Add(NorthWalls[Layer]);
+		LayerWalls.Add(SouthWalls[Layer]);
+		LayerWalls.Add(WestWalls[Layer]);
+		LayerSets.Add(WallSequencer->AddWallSet(LayerWalls));
+	}
+	TArray<AMazeWall*> CenterpieceWalls;
+	CenterpieceWalls.Add(Centerpiece);
+	CenterpieceSet = WallSequencer->AddWallSet(CenterpieceWalls);
 
 }
 
-void AAscensionMaze::Descend() {
-	if (LevelOfAscension > 1) {
-		for (int32 LayerToLower = LevelOfAscension - 1; LayerToLower > 0; LayerToLower--) {
-			EastWalls[NumberOfLayers - LayerToLower - 1]->Lower();
-			NorthWalls[NumberOfLayers - LayerToLower - 1]->Lower();
-			SouthWalls[NumberOfLayers - LayerToLower - 1]->Lower();
-			WestWalls[NumberOfLayers - LayerToLower - 1]->Lower();
-			EastWalls[NumberOfLayers - LayerToLower - 1]->LowerEnabled = true;
-			NorthWalls[NumberOfLayers - LayerToLower - 1]->LowerEnabled = true;
-			SouthWalls[NumberOfLayers - LayerToLower - 1]->LowerEnabled = true;
-			WestWalls[NumberOfLayers - LayerToLower - 1]->LowerEnabled = true;
+bool AAscensionMaze::GetAscensionStep(bool bDescending, int32 Level, TArray<int32>& Sets, EMazeWallAction& Action, int32& NextLevel, bool& bNextDescending) const {
+	Sets.Reset();
+	bNextDescending = bDescending;
+	if (bDescending) {
+		if (Level <= 0) {
+			return false;
 		}
-		Centerpiece->Lower();
-		Centerpiece->LowerEnabled = true;
-		LevelOfAscension--;
-
-		FTimerHandle LayerTimer;
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AAscensionMaze::Descend, 2.1f, false);
-
-	} else if (LevelOfAscension > 0) {
-		Centerpiece->Lower();
-		Centerpiece->LowerEnabled = true;
-		LevelOfAscension--;
-		FTimerHandle LayerTimer;
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AAscensionMaze::Ascend, 2.1f, false);
+		for (int32 LayerToLower = Level - 1; LayerToLower > 0; LayerToLower--) {
+			Sets.Add(NumberOfLayers - LayerToLower - 1);
+		}
+		// The last step down only drops the centerpiece, then the ascent begins.
+		bNextDescending = Level > 1;
+		Action = EMazeWallAction::WA_Lower;
+	} else {
+		int32 LayersToRaise;
+		if (Level >= NumberOfLayers - 1 && Level != NumberOfAscensions) {
+			LayersToRaise = Level % 4 != 3 ? Level % 4 + 1 : 0;
+		} else if (Level < NumberOfLayers - 1 && Level != 0) {
+			LayersToRaise = Level;
+		} else if (Level == 0) {
+			LayersToRaise = 0;
+		} else {
+			return false;
+		}
+		for (int32 LayerToRaise = LayersToRaise; LayerToRaise > 0; LayerToRaise--) {
+			Sets.Add(NumberOfLayers - LayerToRaise - 1);
+		}
+		Action = EMazeWallAction::WA_Raise;
 	}
 
+	// Layer numbers become set indices; layers past either end are skipped.
+	for (int32 Index = Sets.Num() - 1; Index >= 0; Index--) {
+		if (LayerSets.IsValidIndex(Sets[Index])) {
+			Sets[Index] = LayerSets[Sets[Index]];
+		} else {
+			Sets.RemoveAt(Index);
+		}
+	}
+	Sets.Add(CenterpieceSet);
+	NextLevel = bDescending ? Level - 1 : Level + 1;
+	return true;
 }
 
-void AAscensionMaze::Ascend() {
-	if (LevelOfAscension >= NumberOfLayers - 1 && LevelOfAscension != NumberOfAscensions) {
-		if (LevelOfAscension % 4 != 3) {
-			for (int32 LayerToLower = LevelOfAscension % 4 + 1; LayerToLower > 0; LayerToLower--) {
-				EastWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-				NorthWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-				SouthWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-				WestWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-				EastWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
-				NorthWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
-				SouthWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
-				WestWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
-			}
+void AAscensionMaze::CompileSequence() {
+	WallSequencer->ClearEvents();
+
+	TArray<int32> Sets;
+	EMazeWallAction Action;
+	bool bDescending = true;
+	int32 Level = LevelOfAscension;
+	float Time = 0.1f;
+	// Bounded in case a small maze never reaches NumberOfAscensions.
+	const int32 MaxSteps = 2 * NumberOfLayers + NumberOfAscensions + 2;
+	for (int32 Step = 0; Step < MaxSteps; Step++) {
+		int32 NextLevel;
+		bool bNextDescending;
+		if (!GetAscensionStep(bDescending, Level, Sets, Action, NextLevel, bNextDescending)) {
+			break;
 		}
-		Centerpiece->Raise();
-		Centerpiece->RaiseEnabled = true;
-		LevelOfAscension++;
-
-	} else if (LevelOfAscension < NumberOfLayers - 1 && LevelOfAscension != 0) {
-		for (int32 LayerToLower = LevelOfAscension; LayerToLower > 0; LayerToLower--) {
-			EastWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-			NorthWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-			SouthWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-			WestWalls[NumberOfLayers - LayerToLower - 1]->Raise();
-			EastWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
-			NorthWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
-			SouthWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
-			WestWalls[NumberOfLayers - LayerToLower - 1]->RaiseEnabled = true;
+		for (int32 Set : Sets) {
+			WallSequencer->AddEvent(Time, Set, Action);
 		}
-		Centerpiece->Raise();
-		Centerpiece->RaiseEnabled = true;
-		LevelOfAscension++;
-
-	} else if (LevelOfAscension == 0) {
-		Centerpiece->Raise();
-		Centerpiece->RaiseEnabled = true;
-		LevelOfAscension++;
-
-	} else {
-
+		WallSequencer->AddEvent(Time, INDEX_NONE, EMazeWallAction::WA_Marker, NextLevel);
+		Level = NextLevel;
+		bDescending = bNextDescending;
+		Time += LayerStepInterval;
 	}
+}
 
-	FTimerHandle LayerTimer;
-	GetWorldTimerManager().SetTimer(LayerTimer, this, &AAscensionMaze::Ascend, 2.1f, false);
-}
\ No newline at end of file
+void AAscensionMaze::Ascend() {
+	TArray<int32> Sets;
+	EMazeWallAction Action;
+	int32 NextLevel;
+	bool bNextDescending;
+	if (GetAscensionStep(false, LevelOfAscension, Sets, Action, NextLevel, bNextDescending)) {
+		for (int32 Set : Sets) {
+			WallSequencer->DispatchNow(Set, Action);
+		}
+		LevelOfAscension = NextLevel;
+	}
+}
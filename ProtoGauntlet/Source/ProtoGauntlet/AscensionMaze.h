@@ -3,6 +3,7 @@
 #pragma once
 
 #include "MazeSegment.h"
+#include "MazeWallSequencer.h"
 #include "AscensionMaze.generated.h"
 
 /**
@@ -18,7 +19,9 @@ public:
 
 protected:
 
-	void CreateMazeLayout();
+	AAscensionMaze();
+
+	void CreateMazeLayout(FMazeTileGrid& Target);
 
 	void SpawnBorders();
 
@@ -26,12 +29,23 @@ protected:
 
 	void SpawnWalls();
 
+	/** SpawnWalls restarts the ascension and the sequencer. */
+	virtual bool SupportsWallStreaming() const override;
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	/** Raises the next level straight away, outside the compiled sequence. */
 	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
 	void Ascend();
 
+	/** Seconds between levels of the descent and ascent. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Raise and Lower")
+	float LayerStepInterval;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Raise and Lower")
+	UMazeWallSequencer* WallSequencer;
+
 private:
 
 	TArray<AMazeWall*> EastWalls;
@@ -50,7 +64,19 @@ private:
 
 	int32 NumberOfAscensions;
 
-	void Descend();
+	/** Sequencer wall set per layer, east, north, south and west walls together. */
+	TArray<int32> LayerSets;
+
+	int32 CenterpieceSet;
+
+	/**
+	 * The walls one descent or ascent step moves from Level, and the state after it.
+	 * False once there is nothing left to do.
+	 */
+	bool GetAscensionStep(bool bDescending, int32 Level, TArray<int32>& Sets, EMazeWallAction& Action, int32& NextLevel, bool& bNextDescending) const;
+
+	/** Descends to the bottom, then ascends level by level to the top, as one timeline. */
+	void CompileSequence();
 
 	
 };
@@ -3,33 +3,41 @@
 #include "ProtoGauntlet.h"
 #include "CullingMaze.h"
 
+ACullingMaze::ACullingMaze() {
+	// Ticks only to drive the domino wave, once the walls are up.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
 void ACullingMaze::BeginPlay() {
 	Super::BeginPlay();
 
 	PathfindingActive = false;
 }
 
+bool ACullingMaze::SupportsWallStreaming() const {
+	return false;
+}
+
 void ACullingMaze::SpawnWalls() {
-	AMazeWall* CurrentWall;
 	PillarLayers = (MazeLengthInTiles - 5) / 8 + 1;
 	CurrentDominoDirection = EDirection::D_South;
 	float VisibilityOffset = 10.1f; // Keeps the ground from clipping with lowered walls
+	PillarTiles.Init(false, Grid.Num());
+	PillarRings.Reset();
 	for (int y = 0; y < MazeLengthInTiles; y++) {
-		Row[y].ColumnWallRef.SetNum(MazeLengthInTiles);
 		for (int x = 0; x < MazeLengthInTiles; x++) {
-			CurrentWall = Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass));
-			if (CurrentWall) {
-				CurrentWall->SetActorLocation(GetActorLocation() + FVector((float)(x) * TileSize, (float)(y) * TileSize, -InnerWallHeight + FloorHeight - VisibilityOffset));
-				CurrentWall->SetActorScale3D(FVector(TileSize / 100.f, TileSize / 100.f, InnerWallHeight / 100.f));
-				Row[y].ColumnWallRef[x] = CurrentWall;
-			}
+			SpawnWallAt(y, x, FVector((float)(x) * TileSize, (float)(y) * TileSize, FloorHeight - VisibilityOffset), true);
 		}
 
 	}
 
 	FTimerHandle PillarTimer;
 	GetWorldTimerManager().SetTimer(PillarTimer, this, &ACullingMaze::InitialPillarRaise, 0.1f, false);
-	GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 5.f, false);
+	WaveStep = 0;
+	WaveClock = 0.f;
+	SweepStartTime = 5.f;
+	SetActorTickEnabled(true);
 }
 
 void ACullingMaze::SpawnBorders() {
@@ -46,155 +54,143 @@ void ACullingMaze::SpawnFloor() {
 void ACullingMaze::InitialPillarRaise() {
 	for (int32 y = 3; y < MazeLengthInTiles / 2; y += 4) {
 		for (int32 x = 3; x < MazeLengthInTiles / 2; x += 4) {
-			StandingPillars.Emplace(Row[y].ColumnWallRef[x]);
-			Row[y].ColumnWallRef[x]->Raise();
+			RaisePillar(y, x);
 		}
 
 		for (int32 x = (MazeLengthInTiles + 1) / 2; x < MazeLengthInTiles; x += 4) {
-			StandingPillars.Emplace(Row[y].ColumnWallRef[x]);
-			Row[y].ColumnWallRef[x]->Raise();
+			RaisePillar(y, x);
 		}
 
 	}
 	for (int32 y = (MazeLengthInTiles + 1) / 2; y < MazeLengthInTiles; y += 4) {
 		for (int32 x = 3; x < MazeLengthInTiles / 2; x += 4) {
-			StandingPillars.Emplace(Row[y].ColumnWallRef[x]);
-			Row[y].ColumnWallRef[x]->Raise();
+			RaisePillar(y, x);
 		}
 
 		for (int32 x = (MazeLengthInTiles + 1) / 2; x < MazeLengthInTiles; x += 4) {
-			StandingPillars.Emplace(Row[y].ColumnWallRef[x]);
-			Row[y].ColumnWallRef[x]->Raise();
+			RaisePillar(y, x);
 		}
 	}
 
 }
 
+int32 ACullingMaze::GetPillarLine(int32 TileCoordinate) const {
+	// Pillar lines run every four tiles out from either side of the centre line.
+	const int32 FromCentre = TileCoordinate < MazeLengthInTiles / 2
+		? MazeLengthInTiles / 2 - 1 - TileCoordinate
+		: TileCoordinate - (MazeLengthInTiles / 2 + 1);
+	return FromCentre >= 0 && FromCentre % 4 == 0 ? FromCentre / 4 : INDEX_NONE;
+}
+
+void ACullingMaze::RaisePillar(int32 TileRow, int32 TileColumn) {
+	const int32 TileIndex = Grid.Index(TileRow, TileColumn);
+	PillarTiles[TileIndex] = true;
+	RaiseWallAt(TileRow, TileColumn);
+
+	// A pillar drops with the outermost layer whose line it stands on. Ring 0 never drops.
+	int32 Ring = FMath::Max(GetPillarLine(TileRow), GetPillarLine(TileColumn));
+	if (Ring >= PillarLayers) {
+		Ring = FMath::Min(GetPillarLine(TileRow), GetPillarLine(TileColumn));
+	}
+	if (Ring < 1 || Ring >= PillarLayers) {
+		Ring = 0;
+	}
+	if (PillarRings.Num() <= Ring) {
+		PillarRings.SetNum(Ring + 1);
+	}
+	PillarRings[Ring].Add(TileIndex);
+}
+
+bool ACullingMaze::IsStandingPillar(int32 TileRow, int32 TileColumn) {
+	return Grid.IsValid(TileRow, TileColumn) && PillarTiles[Grid.Index(TileRow, TileColumn)];
+}
+
 void ACullingMaze::LowerLayerOfPillars() {
 	if (PillarLayers > 1) {
-		int32 WallIndex = 0;
-		while (WallIndex < StandingPillars.Num()) {
-			if ((int32)(StandingPillars[WallIndex]->GetActorLocation().X / TileSize) == MazeLengthInTiles / 2 - 1 - 4 * (PillarLayers - 1)
-				|| (int32)(StandingPillars[WallIndex]->GetActorLocation().Y / TileSize) == MazeLengthInTiles / 2 - 1 - 4 * (PillarLayers - 1)
-				|| (int32)(StandingPillars[WallIndex]->GetActorLocation().X / TileSize) == MazeLengthInTiles / 2 + 1 + 4 * (PillarLayers - 1)
-				|| (int32)(StandingPillars[WallIndex]->GetActorLocation().Y / TileSize) == MazeLengthInTiles / 2 + 1 + 4 * (PillarLayers - 1)) {
-				StandingPillars[WallIndex]->Lower();
-				StandingPillars.RemoveAt(WallIndex);
-			}
-			else {
-				WallIndex++;
+		const int32 Ring = PillarLayers - 1;
+		if (PillarRings.IsValidIndex(Ring)) {
+			for (int32 TileIndex : PillarRings[Ring]) {
+				PillarTiles[TileIndex] = false;
+				LowerWallAt(TileIndex / Grid.Width, TileIndex % Grid.Width);
 			}
+			PillarRings[Ring].Empty();
 		}
 		PillarLayers--;
 	}
 }
 
-void ACullingMaze::DominoWallsFromDirection() {
-	int32 Index = 0;
-	
-	if (CurrentDominoDirection == EDirection::D_South) {
-		if (!StandingPillars.Find(Row[MazeLengthInTiles - DominoEffectRow - 1].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn - 1], Index)) {
-			if (DominoEffectRow == 0) { 
-				Row[MazeLengthInTiles - DominoEffectRow - 1].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn - 1]->RaiseAndLower();
-			} else if (!StandingPillars.Find(Row[MazeLengthInTiles - DominoEffectRow].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn - 1], Index)) {
-				Row[MazeLengthInTiles - DominoEffectRow - 1].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn - 1]->RaiseAndLower();
-			}
-		}
-
-		DominoEffectColumn++;
-
-		if (DominoEffectColumn == MazeLengthInTiles) {
-			DominoEffectColumn = 0;
-			DominoEffectRow++;
-		}
-
-		if (DominoEffectRow == MazeLengthInTiles) {
-			DominoEffectRow = 0;
-			CurrentDominoDirection = EDirection::D_East;
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 5.f, false);
-		} else {
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 4.f / (6.f * (float)MazeLengthInTiles), false);
-		}
+float ACullingMaze::GetWaveStepInterval() const {
+	return 4.f / (6.f * (float)MazeLengthInTiles);
+}
 
-		
-	} else if (CurrentDominoDirection == EDirection::D_East) {
-		if (!StandingPillars.Find(Row[MazeLengthInTiles - DominoEffectRow - 1].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn - 1], Index)) {
-			if (DominoEffectColumn == 0) {
-				Row[MazeLengthInTiles - DominoEffectRow - 1].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn - 1]->RaiseAndLower();
-			}
-			else if (!StandingPillars.Find(Row[MazeLengthInTiles - DominoEffectRow - 1].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn], Index)) {
-				Row[MazeLengthInTiles - DominoEffectRow - 1].ColumnWallRef[MazeLengthInTiles - DominoEffectColumn - 1]->RaiseAndLower();
-			}
-		}
+bool ACullingMaze::GetWaveTile(EDirection Direction, int32 Step, int32& TileRow, int32& TileColumn) const {
+	if (Step < 0 || Step >= MazeLengthInTiles * MazeLengthInTiles) {
+		return false;
+	}
+	const int32 Outer = Step / MazeLengthInTiles;
+	const int32 Inner = Step % MazeLengthInTiles;
+
+	// North and South sweep row by row, East and West column by column. South and East start from the far corner.
+	const bool bByRow = Direction == EDirection::D_North || Direction == EDirection::D_South;
+	TileRow = bByRow ? Outer : Inner;
+	TileColumn = bByRow ? Inner : Outer;
+	if (Direction == EDirection::D_South || Direction == EDirection::D_East) {
+		TileRow = MazeLengthInTiles - TileRow - 1;
+		TileColumn = MazeLengthInTiles - TileColumn - 1;
+	}
+	return true;
+}
 
-		DominoEffectRow++;
+void ACullingMaze::TriggerWaveStep(int32 Step) {
+	int32 TileRow, TileColumn;
+	if (!GetWaveTile(CurrentDominoDirection, Step, TileRow, TileColumn) || PillarTiles[Grid.Index(TileRow, TileColumn)]) {
+		return;
+	}
 
-		if (DominoEffectRow == MazeLengthInTiles) {
-			DominoEffectRow = 0;
-			DominoEffectColumn++;
+	// A wall sheltered by a pillar on the side the wave comes from stays down.
+	int32 ShelterRow, ShelterColumn;
+	if (Step >= MazeLengthInTiles) {
+		GetWaveTile(CurrentDominoDirection, Step - MazeLengthInTiles, ShelterRow, ShelterColumn);
+		if (PillarTiles[Grid.Index(ShelterRow, ShelterColumn)]) {
+			return;
 		}
+	}
+	RaiseAndLowerWallAt(TileRow, TileColumn);
+}
 
-		if (DominoEffectColumn == MazeLengthInTiles) {
-			DominoEffectColumn = 0;
-			CurrentDominoDirection = EDirection::D_North;
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 5.f, false);
-		}
-		else {
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 4.f / (6.f * (float)MazeLengthInTiles), false);
-		}
+void ACullingMaze::AdvanceWave() {
+	const int32 NumSteps = MazeLengthInTiles * MazeLengthInTiles;
+	const float StepInterval = GetWaveStepInterval();
+	const float SweepPause = 5.f;
 
-	} else if (CurrentDominoDirection == EDirection::D_North) {
-		if (!StandingPillars.Find(Row[DominoEffectRow].ColumnWallRef[DominoEffectColumn], Index)) {
-			if (DominoEffectRow == 0) {
-				Row[DominoEffectRow].ColumnWallRef[DominoEffectColumn]->RaiseAndLower();
-			}
-			else if (!StandingPillars.Find(Row[DominoEffectRow - 1].ColumnWallRef[DominoEffectColumn], Index)) {
-				Row[DominoEffectRow].ColumnWallRef[DominoEffectColumn]->RaiseAndLower();
-			}
+	while (WaveClock >= SweepStartTime) {
+		const int32 DueSteps = FMath::Min(NumSteps, (int32)((WaveClock - SweepStartTime) / StepInterval) + 1);
+		for (; WaveStep < DueSteps; WaveStep++) {
+			TriggerWaveStep(WaveStep);
 		}
-
-		DominoEffectColumn++;
-
-		if (DominoEffectColumn == MazeLengthInTiles) {
-			DominoEffectColumn = 0;
-			DominoEffectRow++;
+		if (WaveStep < NumSteps) {
+			return;
 		}
 
-		if (DominoEffectRow == MazeLengthInTiles) {
-			DominoEffectRow = 0;
+		// The next sweep starts a pause after this one's last step.
+		SweepStartTime += (float)(NumSteps - 1) * StepInterval + SweepPause;
+		WaveStep = 0;
+		if (CurrentDominoDirection == EDirection::D_South) {
+			CurrentDominoDirection = EDirection::D_East;
+		} else if (CurrentDominoDirection == EDirection::D_East) {
+			CurrentDominoDirection = EDirection::D_North;
+		} else if (CurrentDominoDirection == EDirection::D_North) {
 			CurrentDominoDirection = EDirection::D_West;
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 5.f, false);
-		}
-		else {
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 4.f / (6.f * (float)MazeLengthInTiles), false);
-		}
-
-	} else if (CurrentDominoDirection == EDirection::D_West) {
-		if (!StandingPillars.Find(Row[DominoEffectRow].ColumnWallRef[DominoEffectColumn], Index)) {
-			if (DominoEffectColumn == 0) {
-				Row[DominoEffectRow].ColumnWallRef[DominoEffectColumn]->RaiseAndLower();
-			}
-			else if (!StandingPillars.Find(Row[DominoEffectRow].ColumnWallRef[DominoEffectColumn - 1], Index)) {
-				Row[DominoEffectRow].ColumnWallRef[DominoEffectColumn]->RaiseAndLower();
-			}
-		}
-
-		DominoEffectRow++;
-
-		if (DominoEffectRow == MazeLengthInTiles) {
-			DominoEffectRow = 0;
-			DominoEffectColumn++;
-		}
-
-		if (DominoEffectColumn == MazeLengthInTiles) {
-			DominoEffectColumn = 0;
+		} else {
 			CurrentDominoDirection = EDirection::D_North;
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 5.f, false);
 			LowerLayerOfPillars();
 		}
-		else {
-			GetWorldTimerManager().SetTimer(DominoHandle, this, &ACullingMaze::DominoWallsFromDirection, 4.f / (6.f * (float)MazeLengthInTiles), false);
-		}
 	}
+}
+
+void ACullingMaze::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
 
-}
\ No newline at end of file
+	WaveClock += DeltaSeconds;
+	AdvanceWave();
+}
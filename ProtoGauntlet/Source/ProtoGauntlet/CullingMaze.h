@@ -22,24 +22,56 @@ protected:
 	
 	void SpawnWalls();
 
+	/** SpawnWalls lays out the pillar rings and restarts the wave. */
+	virtual bool SupportsWallStreaming() const override;
+
 	void SpawnBorders();
 	
 	void SpawnFloor();
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<AMazeWall*> StandingPillars;
+	/** Tile indices of the standing pillars, grouped by the layer that lowers them. Ring 0 stays up. */
+	TArray<TArray<int32>> PillarRings;
+
+	/** Distance in pillar lines from the centre for a row or column, or INDEX_NONE between lines. */
+	int32 GetPillarLine(int32 TileCoordinate) const;
+
+	/** Raises a pillar and files it under its ring. */
+	void RaisePillar(int32 TileRow, int32 TileColumn);
+
+	UFUNCTION(BlueprintCallable, Category = "Culling")
+	bool IsStandingPillar(int32 TileRow, int32 TileColumn);
 
 	int32 PillarLayers;
 
+	/** One bit per tile, set while that tile's pillar is standing. */
+	TBitArray<> PillarTiles;
+
 	void LowerLayerOfPillars();
-	
-	void DominoWallsFromDirection();
 
+	/** Sweep direction of the wave in progress or next to start. */
 	EDirection CurrentDominoDirection;
-	
-	FTimerHandle DominoHandle;
 
-	int32 DominoEffectRow;
+	/** Steps of the current sweep already triggered, in sweep order. */
+	int32 WaveStep;
+
+	/** Seconds since the walls were spawned. */
+	float WaveClock;
+
+	/** WaveClock time at which the current sweep triggers its first step. */
+	float SweepStartTime;
+
+	/** Seconds between consecutive steps of a sweep. */
+	float GetWaveStepInterval() const;
+
+	/** Tile for a sweep step; false past the end of the sweep. */
+	bool GetWaveTile(EDirection Direction, int32 Step, int32& TileRow, int32& TileColumn) const;
+
+	/** Triggers every step of the wave that has come due, then moves on to the next sweep if this one is done. */
+	void AdvanceWave();
+
+	void TriggerWaveStep(int32 Step);
+
+	ACullingMaze();
 
-	int32 DominoEffectColumn;
+	virtual void Tick(float DeltaSeconds) override;
 };
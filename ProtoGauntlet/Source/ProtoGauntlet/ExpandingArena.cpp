@@ -5,31 +5,31 @@
 
 AExpandingArena::AExpandingArena() {
 	DesiredLayerOfWallsLowered = 3;
+	bOpenLayoutHint = true;
+	LayerStepInterval = 2.1f;
+
+	WallSequencer = CreateDefaultSubobject<UMazeWallSequencer>(TEXT("WallSequencer"));
 }
 
 void AExpandingArena::BeginPlay() {
 	Super::BeginPlay();
 
 	PathfindingActive = true;
-	FTimerHandle LayerTimer;
-	if (DesiredLayerOfWallsLowered > CurrentLayerOfWallsLowered) {
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AExpandingArena::LowerLayerOfWalls, 0.1f, false);
-
-	} else if (DesiredLayerOfWallsLowered < CurrentLayerOfWallsLowered) {
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AExpandingArena::RaiseLayerOfWalls, 0.1f, false);
-
-	}
+	WallSequencer->OnMarker = [this](int32 LayersLowered) {
+		CurrentLayerOfWallsLowered = LayersLowered;
+		UpdateOpenTiles();
+	};
+	CompileLayerSequence(0.1f);
 
 }
 
-void AExpandingArena::CreateMazeLayout() {
-	FMazeRowData WallRow;
+void AExpandingArena::CreateMazeLayout(FMazeTileGrid& Target) {
+	Target.Init(MazeLengthInTiles, MazeLengthInTiles, ETileDesignation::TD_Wall);
 
-	WallRow.Column.Init(ETileDesignation::TD_Wall, MazeLengthInTiles);
-	for (int32 index = 0; index < MazeLengthInTiles; index++) {
-		Row.Add(WallRow);
-	}
+}
 
+bool AExpandingArena::SupportsWallStreaming() const {
+	return false;
 }
 
 void AExpandingArena::SpawnWalls() {
@@ -40,63 +40,62 @@ void AExpandingArena::SpawnWalls() {
 	ColumnWalls.SetNum(0);
 
 	for (int x = 0; x < MazeLengthInTiles; x++) {
-		CurrentWall = Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass));
+		CurrentWall = SpawnSpanningWall(FVector(TileSize, (float)(x + 1) * TileSize, FloorHeight - VisibilityOffset), FVector((float)(MazeLengthInTiles) * TileSize / 100.f, TileSize / 100.f, InnerWallHeight / 100.f));
 		if (CurrentWall) {
-			CurrentWall->SetActorLocation(GetActorLocation() + FVector(TileSize, (float)(x + 1) * TileSize, FloorHeight - VisibilityOffset));
-			CurrentWall->SetActorScale3D(FVector((float)(MazeLengthInTiles) * TileSize / 100.f, TileSize / 100.f, InnerWallHeight / 100.f));
 			RowWalls.Emplace(CurrentWall);
 		}
 
-		CurrentWall = Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass));
+		CurrentWall = SpawnSpanningWall(FVector((float)(x + 1) * TileSize, TileSize, FloorHeight - VisibilityOffset), FVector(TileSize / 100.f, (float)(MazeLengthInTiles) * TileSize / 100.f, InnerWallHeight / 100.f));
 		if (CurrentWall) {
-			CurrentWall->SetActorLocation(GetActorLocation() + FVector((float)(x + 1) * TileSize, TileSize, FloorHeight - VisibilityOffset));
-			CurrentWall->SetActorScale3D(FVector(TileSize / 100.f, (float)(MazeLengthInTiles) * TileSize / 100.f, InnerWallHeight / 100.f));
 			ColumnWalls.Emplace(CurrentWall);
 		}
 	}
 
+	WallSequencer->ResetTimeline();
+	LayerSets.SetNum(0);
+	for (int32 Layer = 0; Layer <= MazeLengthInTiles / 2; Layer++) {
+		TArray<AMazeWall*> LayerWalls;
+		LayerWalls.Add(RowWalls[MazeLengthInTiles / 2 - Layer]);
+		LayerWalls.Add(ColumnWalls[MazeLengthInTiles / 2 - Layer]);
+		LayerWalls.Add(RowWalls[MazeLengthInTiles / 2 + Layer]);
+		LayerWalls.Add(ColumnWalls[MazeLengthInTiles / 2 + Layer]);
+		LayerSets.Add(WallSequencer->AddWallSet(LayerWalls));
+	}
 }
 
-void AExpandingArena::LowerLayerOfWalls() {
-	RowWalls[MazeLengthInTiles / 2 - CurrentLayerOfWallsLowered]->Lower();
-	ColumnWalls[MazeLengthInTiles / 2 - CurrentLayerOfWallsLowered]->Lower();
-	RowWalls[MazeLengthInTiles / 2 + CurrentLayerOfWallsLowered]->Lower();
-	ColumnWalls[MazeLengthInTiles / 2 + CurrentLayerOfWallsLowered]->Lower();
-	CurrentLayerOfWallsLowered++;
-	FTimerHandle LayerTimer;
-
-	if (DesiredLayerOfWallsLowered > CurrentLayerOfWallsLowered) {
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AExpandingArena::LowerLayerOfWalls, 2.1f, false);
+void AExpandingArena::CompileLayerSequence(float FirstDelay) {
+	WallSequencer->ClearEvents();
 
+	const int32 Target = FMath::Clamp(DesiredLayerOfWallsLowered, 0, LayerSets.Num());
+	float Time = FirstDelay;
+	for (int32 Layers = CurrentLayerOfWallsLowered; Layers < Target; Layers++) {
+		WallSequencer->AddEvent(Time, LayerSets[Layers], EMazeWallAction::WA_Lower);
+		WallSequencer->AddEvent(Time, INDEX_NONE, EMazeWallAction::WA_Marker, Layers + 1);
+		Time += LayerStepInterval;
 	}
-	
+	for (int32 Layers = CurrentLayerOfWallsLowered; Layers > Target; Layers--) {
+		WallSequencer->AddEvent(Time, LayerSets[Layers - 1], EMazeWallAction::WA_Raise);
+		WallSequencer->AddEvent(Time, INDEX_NONE, EMazeWallAction::WA_Marker, Layers - 1);
+		Time += LayerStepInterval;
+	}
+	WallSequencer->Play();
 }
 
-void AExpandingArena::RaiseLayerOfWalls() {
-	RowWalls[MazeLengthInTiles / 2 - CurrentLayerOfWallsLowered + 1]->Raise();
-	ColumnWalls[MazeLengthInTiles / 2 - CurrentLayerOfWallsLowered + 1]->Raise();
-	RowWalls[MazeLengthInTiles / 2 + CurrentLayerOfWallsLowered - 1]->Raise();
-	ColumnWalls[MazeLengthInTiles / 2 + CurrentLayerOfWallsLowered - 1]->Raise();
-	CurrentLayerOfWallsLowered--;
-	FTimerHandle LayerTimer;
-
-	if (DesiredLayerOfWallsLowered < CurrentLayerOfWallsLowered) {
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AExpandingArena::RaiseLayerOfWalls, 2.1f, false);
-
+void AExpandingArena::UpdateOpenTiles() {
+	// A tile is open once both the row wall and the column wall over it are lowered.
+	const int32 Center = MazeLengthInTiles / 2;
+	for (int32 y = 0; y < MazeLengthInTiles; y++) {
+		for (int32 x = 0; x < MazeLengthInTiles; x++) {
+			const bool bOpen = FMath::Abs(y - Center) < CurrentLayerOfWallsLowered && FMath::Abs(x - Center) < CurrentLayerOfWallsLowered;
+			Grid.Set(y, x, bOpen ? ETileDesignation::TD_Path : ETileDesignation::TD_Wall);
+		}
 	}
+	RebuildLayoutCaches();
 }
 
 void AExpandingArena::ChangeDesiredLayer(int32 ChosenLayer) {
 	DesiredLayerOfWallsLowered = ChosenLayer;
-	FTimerHandle LayerTimer;
-
-	if (DesiredLayerOfWallsLowered > CurrentLayerOfWallsLowered) {
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AExpandingArena::LowerLayerOfWalls, 2.1f, false);
-
-	} else if (DesiredLayerOfWallsLowered < CurrentLayerOfWallsLowered) {
-		GetWorldTimerManager().SetTimer(LayerTimer, this, &AExpandingArena::RaiseLayerOfWalls, 2.1f, false);
-
-	}
+	CompileLayerSequence(LayerStepInterval);
 }
 
 int32 AExpandingArena::GetCurrentLayerOfWallsLowered() {
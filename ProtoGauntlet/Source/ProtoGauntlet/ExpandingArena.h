@@ -3,6 +3,7 @@
 #pragma once
 
 #include "MazeSegment.h"
+#include "MazeWallSequencer.h"
 #include "ExpandingArena.generated.h"
 
 /**
@@ -21,14 +22,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
 	int32 GetCurrentLayerOfWallsLowered();
 
+	/** Seconds between layers while the arena grows or shrinks. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Raise and Lower")
+	float LayerStepInterval;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Raise and Lower")
+	UMazeWallSequencer* WallSequencer;
+
 protected:
 
 	AExpandingArena();
 
-	void CreateMazeLayout();
+	void CreateMazeLayout(FMazeTileGrid& Target);
 
 	void SpawnWalls();
 
+	/** SpawnWalls restarts the layer count and the sequencer. */
+	virtual bool SupportsWallStreaming() const override;
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
@@ -42,7 +53,12 @@ private:
 
 	int32 CurrentLayerOfWallsLowered;
 	
-	void LowerLayerOfWalls();
+	/** Sequencer wall set per layer: the two row walls and two column walls that many tiles out from the centre. */
+	TArray<int32> LayerSets;
+
+	/** Replaces the timeline with the steps from the current layer to the desired one, the first after FirstDelay. */
+	void CompileLayerSequence(float FirstDelay);
 
-	void RaiseLayerOfWalls();
+	/** Opens the square of tiles under lowered walls and closes the rest. */
+	void UpdateOpenTiles();
 };
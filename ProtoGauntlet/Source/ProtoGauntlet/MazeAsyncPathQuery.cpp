@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeAsyncPathQuery.h"
+#include "MazeSegment.h"
+
+void FMazePathQuery::Launch(const TSharedRef<FMazePathQuery, ESPMode::ThreadSafe>& Query, TFunction<void()> OnGameThread) {
+	FFunctionGraphTask::CreateAndDispatchWhenReady([Query, OnGameThread]() {
+		if (!Query->bCancelled) {
+			// Scratch is per query; workers share nothing but the read-only snapshot.
+			FMazeSearchScratch Scratch;
+			Query->bFound = Query->Layout->FindPath(Scratch, Query->Mode, Query->Request.StartPoint, Query->Request.EndPoint, Query->Request.StartDirection, Query->Path);
+		}
+		Query->bComplete = true;
+
+		if (OnGameThread && !Query->bCancelled) {
+			FFunctionGraphTask::CreateAndDispatchWhenReady(OnGameThread, TStatId(), nullptr, ENamedThreads::GameThread);
+		}
+	}, TStatId(), nullptr, ENamedThreads::AnyThread);
+}
+
+void FMazePathLatentAction::UpdateOperation(FLatentResponse& Response) {
+	if (!Query->bComplete) {
+		return;
+	}
+
+	bFound = Query->bFound;
+	Path.Reset();
+	if (Segment.IsValid()) {
+		Segment->IntPairArraytoVectorArray(Query->Path, Path);
+	}
+	Response.FinishAndTriggerIf(true, ExecutionFunction, OutputLink, CallbackTarget);
+}
+
+void FMazePathLatentAction::NotifyObjectDestroyed() {
+	Query->bCancelled = true;
+}
+
+void FMazePathLatentAction::NotifyActionAborted() {
+	Query->bCancelled = true;
+}
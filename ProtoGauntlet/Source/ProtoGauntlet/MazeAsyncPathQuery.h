@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "LatentActions.h"
+#include "MazeLayoutSnapshot.h"
+
+class AMazeSegment;
+
+/**
+ * One path search running on the task graph against a layout snapshot. The game thread
+ * owns the query through a shared pointer; the worker only writes Path and bFound before
+ * raising bComplete.
+ */
+struct FMazePathQuery
+{
+	TSharedPtr<const FMazeLayoutSnapshot, ESPMode::ThreadSafe> Layout;
+
+	FMazePathRequest Request;
+
+	EPathfindingMode Mode;
+
+	TArray<FIntPair> Path;
+
+	bool bFound;
+
+	FThreadSafeBool bCancelled;
+
+	FThreadSafeBool bComplete;
+
+	FMazePathQuery(const TSharedPtr<const FMazeLayoutSnapshot, ESPMode::ThreadSafe>& InLayout, const FMazePathRequest& InRequest, EPathfindingMode InMode)
+		: Layout(InLayout)
+		, Request(InRequest)
+		, Mode(InMode)
+		, bFound(false)
+	{
+	}
+
+	/**
+	 * Runs Query on a worker thread. If OnGameThread is bound it is then queued on the game
+	 * thread, unless the query was cancelled in the meantime.
+	 */
+	static void Launch(const TSharedRef<FMazePathQuery, ESPMode::ThreadSafe>& Query, TFunction<void()> OnGameThread);
+};
+
+/** Latent action behind AMazeSegment::FindPathBetweenPointsLatent. Polls its query once per frame. */
+class FMazePathLatentAction : public FPendingLatentAction
+{
+public:
+
+	FMazePathLatentAction(AMazeSegment* InSegment, const TSharedRef<FMazePathQuery, ESPMode::ThreadSafe>& InQuery, TArray<FVector>& InPath, bool& InFound, const FLatentActionInfo& LatentInfo)
+		: Segment(InSegment)
+		, Query(InQuery)
+		, Path(InPath)
+		, bFound(InFound)
+		, ExecutionFunction(LatentInfo.ExecutionFunction)
+		, OutputLink(LatentInfo.Linkage)
+		, CallbackTarget(LatentInfo.CallbackTarget)
+	{
+	}
+
+	virtual void UpdateOperation(FLatentResponse& Response) override;
+
+	virtual void NotifyObjectDestroyed() override;
+
+	virtual void NotifyActionAborted() override;
+
+private:
+
+	TWeakObjectPtr<AMazeSegment> Segment;
+
+	TSharedRef<FMazePathQuery, ESPMode::ThreadSafe> Query;
+
+	TArray<FVector>& Path;
+
+	bool& bFound;
+
+	FName ExecutionFunction;
+
+	int32 OutputLink;
+
+	FWeakObjectPtr CallbackTarget;
+};
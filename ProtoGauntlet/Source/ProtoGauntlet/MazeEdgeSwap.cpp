@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeEdgeSwap.h"
+#include "MazePathfinder.h"
+
+namespace
+{
+	/** Connector tiles sit between two cells: exactly one coordinate is odd. */
+	FORCEINLINE bool IsConnector(int32 TileRow, int32 TileColumn)
+	{
+		return (TileRow % 2 == 1) != (TileColumn % 2 == 1);
+	}
+}
+
+int32 FMazeEdgeSwap::Apply(FMazeTileGrid& Grid, int32 NumSwaps, FMazeRandomStream& Random, FMazeSearchScratch& Scratch) {
+	TArray<FIntPair> ClosedConnectors;
+	TArray<FIntPair> Loop;
+	TArray<int32> LoopConnectors;
+
+	int32 SwapsMade = 0;
+	for (; SwapsMade < NumSwaps; SwapsMade++) {
+		ClosedConnectors.Reset();
+		for (int32 y = 0; y < Grid.Height; y++) {
+			for (int32 x = (y + 1) % 2; x < Grid.Width; x += 2) {
+				if (Grid.Get(y, x) == ETileDesignation::TD_Wall) {
+					ClosedConnectors.Add(FIntPair(x, y));
+				}
+			}
+		}
+		if (ClosedConnectors.Num() == 0) {
+			break;
+		}
+
+		const FIntPair Opened = ClosedConnectors[Random.RandRange(0, ClosedConnectors.Num() - 1)];
+		const bool bVertical = Opened.y % 2 == 1;
+		const FIntPair CellA = bVertical ? FIntPair(Opened.x, Opened.y - 1) : FIntPair(Opened.x - 1, Opened.y);
+		const FIntPair CellB = bVertical ? FIntPair(Opened.x, Opened.y + 1) : FIntPair(Opened.x + 1, Opened.y);
+
+		// The existing route between the two cells plus the opened wall forms the loop.
+		Loop.Reset();
+		LoopConnectors.Reset();
+		if (FMazePathfinder::FindPathBreadthFirst(Grid, Scratch, CellA, CellB, EDirection::D_None, Loop)) {
+			for (int32 i = 0; i < Loop.Num(); i++) {
+				if (IsConnector(Loop[i].y, Loop[i].x)) {
+					LoopConnectors.Add(i);
+				}
+			}
+		}
+
+		Grid.Set(Opened.y, Opened.x, ETileDesignation::TD_Path);
+		if (LoopConnectors.Num() != 0) {
+			const FIntPair& Closed = Loop[LoopConnectors[Random.RandRange(0, LoopConnectors.Num() - 1)]];
+			Grid.Set(Closed.y, Closed.x, ETileDesignation::TD_Wall);
+		}
+	}
+	return SwapsMade;
+}
@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeSearchScratch.h"
+
+/**
+ * Small random edits to a maze on the cell lattice. Each swap opens a closed wall between
+ * two cells, which closes a loop through the maze, then walls up a random other passage
+ * on that loop. Connectivity is kept, a perfect maze stays perfect, and every swap changes
+ * exactly two tiles.
+ */
+struct FMazeEdgeSwap
+{
+	/** Applies up to NumSwaps swaps to Grid's tiles and returns how many were made. */
+	static int32 Apply(FMazeTileGrid& Grid, int32 NumSwaps, FMazeRandomStream& Random, FMazeSearchScratch& Scratch);
+};
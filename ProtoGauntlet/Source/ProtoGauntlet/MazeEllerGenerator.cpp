@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeEllerGenerator.h"
+
+void FMazeEllerGenerator::Begin(int32 InWidth, int32 InHeight) {
+	Width = FMath::Max(InWidth, 0);
+	Height = FMath::Max(InHeight, 0);
+	CellRow = 0;
+
+	const int32 CellColumns = (Width + 1) / 2;
+	Labels.SetNumUninitialized(CellColumns);
+	for (int32 Column = 0; Column < CellColumns; Column++) {
+		Labels[Column] = Column;
+	}
+	Parents.SetNumUninitialized(CellColumns);
+	LastColumns.SetNumUninitialized(CellColumns);
+	HasPassageDown.SetNumUninitialized(CellColumns);
+	LabelsInUse.SetNumUninitialized(CellColumns);
+	RowTiles.SetNumUninitialized(Width);
+}
+
+int32 FMazeEllerGenerator::FindSet(int32 Label) {
+	while (Parents[Label] != Label) {
+		Parents[Label] = Parents[Parents[Label]];
+		Label = Parents[Label];
+	}
+	return Label;
+}
+
+void FMazeEllerGenerator::EmitNextCellRow(FMazeRandomStream& Random, FRowSink Sink) {
+	if (IsComplete()) {
+		return;
+	}
+
+	const int32 CellColumns = Labels.Num();
+	const bool bLastRow = CellRow * 2 + 2 >= Height;
+	for (int32 Label = 0; Label < CellColumns; Label++) {
+		Parents[Label] = Label;
+	}
+
+	// Cell row: join neighbors in different sets at random. The last row joins every set, closing the maze.
+	for (int32 x = 0; x < Width; x++) {
+		RowTiles[x] = x % 2 == 0 ? ETileDesignation::TD_Path : ETileDesignation::TD_Wall;
+	}
+	for (int32 Column = 0; Column + 1 < CellColumns; Column++) {
+		const int32 Left = FindSet(Labels[Column]);
+		const int32 Right = FindSet(Labels[Column + 1]);
+		if (Left != Right && (bLastRow || (Random.GetUInt32() & 1) != 0)) {
+			Parents[Right] = Left;
+			RowTiles[Column * 2 + 1] = ETileDesignation::TD_Path;
+		}
+	}
+	Sink(CellRow * 2, RowTiles);
+
+	if (bLastRow) {
+		CellRow++;
+		return;
+	}
+
+	// Connector row: every set drops at least one passage, or it would be cut off from the rest.
+	for (int32 Column = 0; Column < CellColumns; Column++) {
+		Labels[Column] = FindSet(Labels[Column]);
+		LastColumns[Labels[Column]] = Column;
+		HasPassageDown[Labels[Column]] = false;
+		LabelsInUse[Column] = false;
+	}
+	for (int32 x = 0; x < Width; x++) {
+		RowTiles[x] = ETileDesignation::TD_Wall;
+	}
+	for (int32 Column = 0; Column < CellColumns; Column++) {
+		const int32 Set = Labels[Column];
+		if ((Random.GetUInt32() & 1) != 0 || (LastColumns[Set] == Column && !HasPassageDown[Set])) {
+			HasPassageDown[Set] = true;
+			LabelsInUse[Set] = true;
+			RowTiles[Column * 2] = ETileDesignation::TD_Path;
+		} else {
+			Labels[Column] = INDEX_NONE;
+		}
+	}
+	Sink(CellRow * 2 + 1, RowTiles);
+
+	// Cells below a wall start in sets of their own.
+	int32 FreeLabel = 0;
+	for (int32 Column = 0; Column < CellColumns; Column++) {
+		if (Labels[Column] == INDEX_NONE) {
+			while (LabelsInUse[FreeLabel]) {
+				FreeLabel++;
+			}
+			Labels[Column] = FreeLabel++;
+		}
+	}
+	CellRow++;
+}
+
+void FMazeEllerGenerator::Generate(int32 Width, int32 Height, FMazeRandomStream& Random, FRowSink Sink) {
+	FMazeEllerGenerator Generator;
+	Generator.Begin(Width, Height);
+	while (!Generator.IsComplete()) {
+		Generator.EmitNextCellRow(Random, Sink);
+	}
+}
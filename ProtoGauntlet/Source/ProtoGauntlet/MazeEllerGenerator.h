@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeRandomStream.h"
+#include "MyActor.h"
+
+/**
+ * Eller's algorithm, producing a perfect maze on the same lattice as the recursive
+ * backtracker (cells on even/even tiles). Only the current row's set labels are kept, so
+ * working memory is O(Width) whatever the height, and each finished tile row is handed to
+ * a sink as soon as it is known. Rows are emitted top to bottom, each exactly once.
+ */
+class FMazeEllerGenerator
+{
+public:
+
+	/** Receives one finished tile row of Width designations. The row buffer is reused for the next row. */
+	typedef TFunctionRef<void(int32 TileRow, const TArray<ETileDesignation>& Tiles)> FRowSink;
+
+	FMazeEllerGenerator()
+	{
+		Width = 0;
+		Height = 0;
+		CellRow = 0;
+	}
+
+	/** Prepares a Width x Height tile maze. Both should be odd so the lattice ends on cells. */
+	void Begin(int32 InWidth, int32 InHeight);
+
+	FORCEINLINE bool IsComplete() const
+	{
+		return CellRow * 2 >= Height;
+	}
+
+	/** Emits the next row of cells and, unless it is the last, the connector row beneath it. */
+	void EmitNextCellRow(FMazeRandomStream& Random, FRowSink Sink);
+
+	/** Generates a whole maze in one go. */
+	static void Generate(int32 Width, int32 Height, FMazeRandomStream& Random, FRowSink Sink);
+
+private:
+
+	int32 Width;
+
+	int32 Height;
+
+	int32 CellRow;
+
+	/** Set of each cell in the current row. Labels are below the number of cell columns. */
+	TArray<int32> Labels;
+
+	/** Union-find over the labels, reset for every row. */
+	TArray<int32> Parents;
+
+	/** Per set: its rightmost column in this row, and whether it has already dropped a passage. */
+	TArray<int32> LastColumns;
+
+	TArray<bool> HasPassageDown;
+
+	/** Labels carried into the next row, so fresh cells get labels nobody holds. */
+	TArray<bool> LabelsInUse;
+
+	TArray<ETileDesignation> RowTiles;
+
+	int32 FindSet(int32 Label);
+};
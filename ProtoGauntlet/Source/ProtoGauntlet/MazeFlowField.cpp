@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeFlowField.h"
+
+namespace
+{
+	// Flee values are -1.2 * distance, kept integral by measuring in fifths of a step.
+	const int32 FleeStepCost = 5;
+	const int32 FleeDistanceScale = -6;
+}
+
+void FMazeFlowField::Build(const FMazeTileGrid& Grid, FIntPair InTargetTile, bool bInFlee) {
+	Width = Grid.Width;
+	Height = Grid.Height;
+	TargetTile = InTargetTile;
+	bFlee = bInFlee;
+
+	Distances.Init(INDEX_NONE, Grid.Num());
+	NextDirections.Init((uint8)EDirection::D_None, Grid.Num());
+	if (!Grid.IsValid(TargetTile.y, TargetTile.x) || Grid.Get(TargetTile.y, TargetTile.x) == ETileDesignation::TD_Wall) {
+		return;
+	}
+
+	Queue.Reset();
+	Queue.Add(Grid.Index(TargetTile.y, TargetTile.x));
+	Distances[Queue[0]] = 0;
+	for (int32 Head = 0; Head < Queue.Num(); Head++) {
+		const int32 Current = Queue[Head];
+		const FIntPair CurrentTile(Current % Width, Current / Width);
+		for (uint8 Direction = 0; Direction < 4; Direction++) {
+			const FIntPair Neighbor = FMazeTileGrid::Step(CurrentTile, (EDirection)Direction);
+			if (Grid.IsPath(Neighbor.y, Neighbor.x) && Distances[Grid.Index(Neighbor.y, Neighbor.x)] == INDEX_NONE) {
+				Distances[Grid.Index(Neighbor.y, Neighbor.x)] = Distances[Current] + 1;
+				Queue.Add(Grid.Index(Neighbor.y, Neighbor.x));
+			}
+		}
+	}
+
+	if (!bFlee) {
+		StoreDescentDirections(Grid, Distances);
+		return;
+	}
+
+	// Relax the scaled map so tiles near a dead end learn to double back past the target.
+	FleeValues.Init(0, Grid.Num());
+	Open.Reset();
+	for (int32 TileIndex : Queue) {
+		FleeValues[TileIndex] = Distances[TileIndex] * FleeDistanceScale;
+		Open.HeapPush(FMazeOpenNode(FleeValues[TileIndex], FleeValues[TileIndex], TileIndex), TLess<FMazeOpenNode>());
+	}
+
+	FMazeOpenNode Node(0, 0, INDEX_NONE);
+	while (Open.Num() != 0) {
+		Open.HeapPop(Node, TLess<FMazeOpenNode>(), false);
+		if (Node.Cost != FleeValues[Node.TileIndex]) {
+			continue;
+		}
+
+		const FIntPair CurrentTile(Node.TileIndex % Width, Node.TileIndex / Width);
+		for (uint8 Direction = 0; Direction < 4; Direction++) {
+			const FIntPair Neighbor = FMazeTileGrid::Step(CurrentTile, (EDirection)Direction);
+			if (!IsInside(Neighbor)) {
+				continue;
+			}
+
+			const int32 NeighborIndex = Grid.Index(Neighbor.y, Neighbor.x);
+			const int32 NeighborValue = Node.Cost + FleeStepCost;
+			if (Distances[NeighborIndex] != INDEX_NONE && NeighborValue < FleeValues[NeighborIndex]) {
+				FleeValues[NeighborIndex] = NeighborValue;
+				Open.HeapPush(FMazeOpenNode(NeighborValue, NeighborValue, NeighborIndex), TLess<FMazeOpenNode>());
+			}
+		}
+	}
+	StoreDescentDirections(Grid, FleeValues);
+}
+
+void FMazeFlowField::StoreDescentDirections(const FMazeTileGrid& Grid, const TArray<int32>& Values) {
+	for (int32 TileIndex : Queue) {
+		const FIntPair Tile(TileIndex % Width, TileIndex / Width);
+		int32 BestValue = Values[TileIndex];
+		uint8 BestDirection = (uint8)EDirection::D_None;
+		for (uint8 Direction = 0; Direction < 4; Direction++) {
+			const FIntPair Neighbor = FMazeTileGrid::Step(Tile, (EDirection)Direction);
+			if (!IsInside(Neighbor)) {
+				continue;
+			}
+
+			const int32 NeighborIndex = Grid.Index(Neighbor.y, Neighbor.x);
+			if (Distances[NeighborIndex] != INDEX_NONE && Values[NeighborIndex] < BestValue) {
+				BestValue = Values[NeighborIndex];
+				BestDirection = Direction;
+			}
+		}
+		NextDirections[TileIndex] = BestDirection;
+	}
+}
+
+#if WITH_EDITOR
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMazeFlowFieldFleeTest, "ProtoGauntlet.Maze.FlowField.Flee", EAutomationTestFlags::ATF_Editor)
+
+bool FMazeFlowFieldFleeTest::RunTest(const FString& Parameters) {
+	// Row 0 is a corridor running east from the target at (0, 0); (1, 1) is a dead end hanging off it.
+	FMazeTileGrid Grid;
+	Grid.Init(10, 3, ETileDesignation::TD_Wall);
+	for (int32 x = 0; x < Grid.Width; x++) {
+		Grid.Set(0, x, ETileDesignation::TD_Path);
+	}
+	Grid.Set(1, 1, ETileDesignation::TD_Path);
+
+	FMazeFlowField Field;
+	Field.Build(Grid, FIntPair(0, 0), true);
+	TestEqual(TEXT("Next to the target, flee takes the long corridor"), Field.GetNextDirection(FIntPair(1, 0)), EDirection::D_East);
+	TestEqual(TEXT("From the dead end, flee doubles back toward the corridor"), Field.GetNextDirection(FIntPair(1, 1)), EDirection::D_North);
+
+	FIntPair Tile(1, 1);
+	for (int32 Steps = 0; Steps < Grid.Num() && Field.GetNextDirection(Tile) != EDirection::D_None; Steps++) {
+		Tile = FMazeTileGrid::Step(Tile, Field.GetNextDirection(Tile));
+	}
+	TestTrue(TEXT("Flee ends at the far end of the corridor"), Tile.x == Grid.Width - 1 && Tile.y == 0);
+	return true;
+}
+#endif
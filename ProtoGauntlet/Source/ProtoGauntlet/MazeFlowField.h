@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeSearchScratch.h"
+
+/**
+ * Distance map from one target tile over the path tiles of a grid, with the best next
+ * step stored per tile. One build serves every agent heading for (or away from) the same
+ * target, each asking for its next step in O(1).
+ *
+ * Flee fields scale the distances by a negative factor and relax them again, so agents
+ * run toward the far side of the maze instead of into the nearest dead end.
+ */
+struct FMazeFlowField
+{
+	FMazeFlowField()
+	{
+		Width = 0;
+		Height = 0;
+		bFlee = false;
+	}
+
+	/** Rebuilds the field toward TargetTile, or away from it if bInFlee. */
+	void Build(const FMazeTileGrid& Grid, FIntPair InTargetTile, bool bInFlee);
+
+	FORCEINLINE bool IsBuilt() const
+	{
+		return Width != 0;
+	}
+
+	FORCEINLINE FIntPair GetTargetTile() const
+	{
+		return TargetTile;
+	}
+
+	FORCEINLINE bool IsFlee() const
+	{
+		return bFlee;
+	}
+
+	/** Direction of the best next step from Tile. D_None at the goal or where the target is unreachable. */
+	FORCEINLINE EDirection GetNextDirection(FIntPair Tile) const
+	{
+		if (!IsInside(Tile)) {
+			return EDirection::D_None;
+		}
+		return (EDirection)NextDirections[Tile.y * Width + Tile.x];
+	}
+
+	/** Steps from Tile to the target, or INDEX_NONE if unreachable. Flee fields keep the same distances. */
+	FORCEINLINE int32 GetDistance(FIntPair Tile) const
+	{
+		if (!IsInside(Tile)) {
+			return INDEX_NONE;
+		}
+		return Distances[Tile.y * Width + Tile.x];
+	}
+
+private:
+
+	int32 Width;
+
+	int32 Height;
+
+	FIntPair TargetTile;
+
+	bool bFlee;
+
+	/** BFS steps to the target per tile, INDEX_NONE where unreachable. */
+	TArray<int32> Distances;
+
+	/** EDirection of the next step per tile. */
+	TArray<uint8> NextDirections;
+
+	/** Flee values per tile, kept so rebuilds do not reallocate. */
+	TArray<int32> FleeValues;
+
+	TArray<int32> Queue;
+
+	TArray<FMazeOpenNode> Open;
+
+	FORCEINLINE bool IsInside(FIntPair Tile) const
+	{
+		return Tile.x >= 0 && Tile.y >= 0 && Tile.x < Width && Tile.y < Height;
+	}
+
+	/** Points every reachable tile at its neighbor with the lowest value, if lower than its own. */
+	void StoreDescentDirections(const FMazeTileGrid& Grid, const TArray<int32>& Values);
+};
+
+/** A flow field kept for one target actor. */
+struct FMazeTargetFlowField
+{
+	TWeakObjectPtr<AActor> Target;
+
+	FMazeFlowField Field;
+};
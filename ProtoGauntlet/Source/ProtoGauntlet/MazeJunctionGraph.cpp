@@ -0,0 +1,456 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeJunctionGraph.h"
+
+namespace
+{
+	FORCEINLINE uint8 OppositeDirection(uint8 Direction)
+	{
+		return (Direction + 2) & 3;
+	}
+
+	/** Where a route leaves the start tile: a corridor stretch ending on a junction. */
+	struct FJunctionSeed
+	{
+		int32 Node;
+
+		int32 Cost;
+
+		int32 Corridor;
+
+		int32 FirstPosition;
+
+		int32 LastPosition;
+	};
+}
+
+void FMazeJunctionGraph::Build(const FMazeTileGrid& Grid) {
+	Width = Grid.Width;
+	Height = Grid.Height;
+	const int32 NumTiles = Grid.Num();
+
+	TileNodes.Init(INDEX_NONE, NumTiles);
+	TileCorridors.Init(INDEX_NONE, NumTiles);
+	TilePositions.Init(0, NumTiles);
+	Hops.Init(FMazeJunctionHop(INDEX_NONE, 0), NumTiles * 4);
+	NodeTiles.Reset();
+	Corridors.Reset();
+	CorridorTiles.Reset();
+
+	for (int32 y = 0; y < Height; y++) {
+		for (int32 x = 0; x < Width; x++) {
+			if (!Grid.IsPath(y, x)) {
+				continue;
+			}
+
+			int32 PathNeighbors = 0;
+			for (uint8 Direction = 0; Direction < 4; Direction++) {
+				const FIntPair Neighbor = FMazeTileGrid::Step(FIntPair(x, y), (EDirection)Direction);
+				PathNeighbors += Grid.IsPath(Neighbor.y, Neighbor.x) ? 1 : 0;
+			}
+
+			if (PathNeighbors != 2) {
+				TileNodes[Grid.Index(y, x)] = NodeTiles.Add(Grid.Index(y, x));
+			}
+		}
+	}
+
+	NodeCorridors.Init(INDEX_NONE, NodeTiles.Num() * 4);
+
+	// Walk every corridor once, starting from whichever end is reached first.
+	TArray<uint8> ForwardDirections;
+	for (int32 Node = 0; Node < NodeTiles.Num(); Node++) {
+		const FIntPair NodeTile = TileToPoint(NodeTiles[Node]);
+		for (uint8 StartDirection = 0; StartDirection < 4; StartDirection++) {
+			const FIntPair First = FMazeTileGrid::Step(NodeTile, (EDirection)StartDirection);
+			if (NodeCorridors[Node * 4 + StartDirection] != INDEX_NONE || !Grid.IsPath(First.y, First.x)) {
+				continue;
+			}
+
+			FMazeCorridor Corridor;
+			Corridor.From = Node;
+			Corridor.FromDirection = StartDirection;
+			Corridor.FirstTile = CorridorTiles.Num();
+			const int32 CorridorIndex = Corridors.Num();
+
+			ForwardDirections.Reset();
+			FIntPair Current = First;
+			uint8 Heading = StartDirection;
+			int32 Length = 1;
+			while (TileNodes[Grid.Index(Current.y, Current.x)] == INDEX_NONE) {
+				const int32 TileIndex = Grid.Index(Current.y, Current.x);
+				const uint8 Back = OppositeDirection(Heading);
+				CorridorTiles.Add(TileIndex);
+				TileCorridors[TileIndex] = CorridorIndex;
+				TilePositions[TileIndex] = Length;
+				Hops[TileIndex * 4 + Back] = FMazeJunctionHop(Node, Length);
+
+				// Corridor tiles have exactly two path neighbors; leave by the one not behind us.
+				for (uint8 Direction = 0; Direction < 4; Direction++) {
+					const FIntPair Neighbor = FMazeTileGrid::Step(Current, (EDirection)Direction);
+					if (Direction != Back && Grid.IsPath(Neighbor.y, Neighbor.x)) {
+						Heading = Direction;
+						break;
+					}
+				}
+				ForwardDirections.Add(Heading);
+				Current = FMazeTileGrid::Step(Current, (EDirection)Heading);
+				Length++;
+			}
+
+			Corridor.To = TileNodes[Grid.Index(Current.y, Current.x)];
+			Corridor.ToDirection = OppositeDirection(Heading);
+			Corridor.Length = Length;
+			Corridors.Add(Corridor);
+
+			NodeCorridors[Node * 4 + StartDirection] = CorridorIndex;
+			NodeCorridors[Corridor.To * 4 + Corridor.ToDirection] = CorridorIndex;
+			Hops[NodeTiles[Node] * 4 + StartDirection] = FMazeJunctionHop(Corridor.To, Length);
+			Hops[NodeTiles[Corridor.To] * 4 + Corridor.ToDirection] = FMazeJunctionHop(Node, Length);
+			for (int32 Position = 1; Position < Length; Position++) {
+				const int32 TileIndex = CorridorTiles[Corridor.FirstTile + Position - 1];
+				Hops[TileIndex * 4 + ForwardDirections[Position - 1]] = FMazeJunctionHop(Corridor.To, Length - Position);
+			}
+		}
+	}
+}
+
+bool FMazeJunctionGraph::GetNextJunction(FIntPair Tile, EDirection Direction, FIntPair& Junction, int32& Distance) const {
+	if (!Contains(Tile) || Direction == EDirection::D_None) {
+		return false;
+	}
+
+	const FMazeJunctionHop& Hop = Hops[(Tile.y * Width + Tile.x) * 4 + (uint8)Direction];
+	if (Hop.Node == INDEX_NONE) {
+		return false;
+	}
+	Junction = TileToPoint(NodeTiles[Hop.Node]);
+	Distance = Hop.Distance;
+	return true;
+}
+
+void FMazeJunctionGraph::AppendCorridor(int32 CorridorIndex, int32 First, int32 Last, TArray<FIntPair>& Path) const {
+	const FMazeCorridor& Corridor = Corridors[CorridorIndex];
+	const int32 Step = First <= Last ? 1 : -1;
+	for (int32 Position = First; ; Position += Step) {
+		Path.Add(TileToPoint(CorridorTileAt(Corridor, Position)));
+		if (Position == Last) {
+			break;
+		}
+	}
+}
+
+bool FMazeJunctionGraph::FindPath(FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) const {
+	if (!Contains(StartPoint) || !Contains(EndPoint)) {
+		return false;
+	}
+
+	// A heading blocks the other neighbors of the start for the whole route.
+	int32 BlockedTiles[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+	int32 HeadingTile = INDEX_NONE;
+	if (StartDirection != EDirection::D_None) {
+		const FIntPair Heading = FMazeTileGrid::Step(StartPoint, StartDirection);
+		if (!Contains(Heading)) {
+			return false;
+		}
+		HeadingTile = Heading.y * Width + Heading.x;
+
+		int32 NumBlocked = 0;
+		for (uint8 Direction = 0; Direction < 4; Direction++) {
+			const FIntPair Neighbor = FMazeTileGrid::Step(StartPoint, (EDirection)Direction);
+			if ((EDirection)Direction != StartDirection && Contains(Neighbor)) {
+				BlockedTiles[NumBlocked++] = Neighbor.y * Width + Neighbor.x;
+			}
+		}
+	}
+	auto IsBlocked = [&BlockedTiles](int32 TileIndex) {
+		return TileIndex == BlockedTiles[0] || TileIndex == BlockedTiles[1] || TileIndex == BlockedTiles[2];
+	};
+
+	const int32 StartIndex = StartPoint.y * Width + StartPoint.x;
+	const int32 EndIndex = EndPoint.y * Width + EndPoint.x;
+	if (StartIndex == EndIndex) {
+		Path.Add(StartPoint);
+		return true;
+	}
+	if (IsBlocked(EndIndex)) {
+		return false;
+	}
+
+	const int32 StartNode = TileNodes[StartIndex];
+	const int32 StartCorridor = TileCorridors[StartIndex];
+	const int32 StartPosition = TilePositions[StartIndex];
+	const int32 EndNode = TileNodes[EndIndex];
+	const int32 EndCorridor = TileCorridors[EndIndex];
+	const int32 EndPosition = TilePositions[EndIndex];
+	auto IsBanned = [&](int32 Node) {
+		return IsBlocked(NodeTiles[Node]) || (HeadingTile != INDEX_NONE && Node == StartNode);
+	};
+
+	// Routes can leave the start along at most two corridor stretches.
+	FJunctionSeed Seeds[2];
+	int32 NumSeeds = 0;
+	int32 DirectCorridor = INDEX_NONE;
+	int32 DirectFirst = 0;
+	if (StartNode != INDEX_NONE && HeadingTile == INDEX_NONE) {
+		FJunctionSeed Seed = { StartNode, 0, INDEX_NONE, 0, 0 };
+		Seeds[NumSeeds++] = Seed;
+	} else if (StartNode != INDEX_NONE) {
+		DirectCorridor = NodeCorridors[StartNode * 4 + (uint8)StartDirection];
+		const FMazeCorridor& Corridor = Corridors[DirectCorridor];
+		const bool bFromStart = Corridor.From == StartNode && Corridor.FromDirection == (uint8)StartDirection;
+		DirectFirst = bFromStart ? 0 : Corridor.Length;
+		const int32 FarNode = bFromStart ? Corridor.To : Corridor.From;
+		if (!IsBanned(FarNode)) {
+			FJunctionSeed Seed = { FarNode, Corridor.Length, DirectCorridor, DirectFirst, Corridor.Length - DirectFirst };
+			Seeds[NumSeeds++] = Seed;
+		}
+	} else {
+		const FMazeCorridor& Corridor = Corridors[StartCorridor];
+		const bool bTowardFrom = HeadingTile == INDEX_NONE || CorridorTileAt(Corridor, StartPosition - 1) == HeadingTile;
+		const bool bTowardTo = HeadingTile == INDEX_NONE || CorridorTileAt(Corridor, StartPosition + 1) == HeadingTile;
+		if (bTowardFrom && !IsBanned(Corridor.From)) {
+			FJunctionSeed Seed = { Corridor.From, StartPosition, StartCorridor, StartPosition, 0 };
+			Seeds[NumSeeds++] = Seed;
+		}
+		if (bTowardTo && !IsBanned(Corridor.To)) {
+			FJunctionSeed Seed = { Corridor.To, Corridor.Length - StartPosition, StartCorridor, StartPosition, Corridor.Length };
+			Seeds[NumSeeds++] = Seed;
+		}
+		if (EndCorridor == StartCorridor && ((EndPosition < StartPosition && bTowardFrom) || (EndPosition > StartPosition && bTowardTo))) {
+			DirectCorridor = StartCorridor;
+			DirectFirst = StartPosition;
+		}
+	}
+
+	int32 BestCost = MAX_int32;
+	int32 BestNode = INDEX_NONE;
+	int32 BestEndFirst = 0;
+	if (DirectCorridor != INDEX_NONE && EndCorridor == DirectCorridor) {
+		BestCost = FMath::Abs(EndPosition - DirectFirst);
+	} else {
+		DirectCorridor = INDEX_NONE;
+	}
+
+	Scratch.Begin(NodeTiles.Num());
+	TArray<FMazeOpenNode>& Open = Scratch.Open;
+	auto Estimate = [&](int32 Node, int32 Cost) {
+		const FIntPair NodeTile = TileToPoint(NodeTiles[Node]);
+		return Cost + FMath::Abs(NodeTile.x - EndPoint.x) + FMath::Abs(NodeTile.y - EndPoint.y);
+	};
+
+	for (int32 SeedIndex = 0; SeedIndex < NumSeeds; SeedIndex++) {
+		const FJunctionSeed& Seed = Seeds[SeedIndex];
+		if (!Scratch.IsDiscovered(Seed.Node) || Seed.Cost < Scratch.Cost[Seed.Node]) {
+			// Negative parents below INDEX_NONE name the seed a node was reached from.
+			Scratch.Discover(Seed.Node, Seed.Cost, -2 - SeedIndex);
+			Open.HeapPush(FMazeOpenNode(Estimate(Seed.Node, Seed.Cost), Seed.Cost, Seed.Node), TLess<FMazeOpenNode>());
+		}
+	}
+
+	FMazeOpenNode Top(0, 0, INDEX_NONE);
+	while (Open.Num() != 0 && Open.HeapTop().Estimate < BestCost) {
+		Open.HeapPop(Top, TLess<FMazeOpenNode>(), false);
+		if (Top.Cost != Scratch.Cost[Top.TileIndex]) {
+			continue;
+		}
+
+		const int32 Node = Top.TileIndex;
+		if (EndNode != INDEX_NONE) {
+			if (Node == EndNode) {
+				BestCost = Top.Cost;
+				BestNode = Node;
+				break;
+			}
+		} else {
+			// The end sits inside a corridor; finish from either end that avoids the start.
+			const FMazeCorridor& Corridor = Corridors[EndCorridor];
+			const bool bSameAsStart = EndCorridor == StartCorridor;
+			if (Corridor.From == Node && (!bSameAsStart || EndPosition < StartPosition) && Top.Cost + EndPosition < BestCost) {
+				BestCost = Top.Cost + EndPosition;
+				BestNode = Node;
+				BestEndFirst = 0;
+			}
+			if (Corridor.To == Node && (!bSameAsStart || EndPosition > StartPosition) && Top.Cost + Corridor.Length - EndPosition < BestCost) {
+				BestCost = Top.Cost + Corridor.Length - EndPosition;
+				BestNode = Node;
+				BestEndFirst = Corridor.Length;
+			}
+		}
+
+		for (uint8 Direction = 0; Direction < 4; Direction++) {
+			const int32 CorridorIndex = NodeCorridors[Node * 4 + Direction];
+			if (CorridorIndex == INDEX_NONE || CorridorIndex == StartCorridor) {
+				continue;
+			}
+
+			const FMazeCorridor& Corridor = Corridors[CorridorIndex];
+			const int32 Neighbor = (Corridor.From == Node && Corridor.FromDirection == Direction) ? Corridor.To : Corridor.From;
+			const int32 NeighborCost = Top.Cost + Corridor.Length;
+			if (IsBanned(Neighbor) || (Scratch.IsDiscovered(Neighbor) && Scratch.Cost[Neighbor] <= NeighborCost)) {
+				continue;
+			}
+
+			Scratch.Discover(Neighbor, NeighborCost, CorridorIndex);
+			Open.HeapPush(FMazeOpenNode(Estimate(Neighbor, NeighborCost), NeighborCost, Neighbor), TLess<FMazeOpenNode>());
+		}
+	}
+
+	if (BestCost == MAX_int32) {
+		return false;
+	}
+
+	if (BestNode == INDEX_NONE) {
+		AppendCorridor(DirectCorridor, DirectFirst, EndPosition, Path);
+		return true;
+	}
+
+	// Collect the corridors back to the seed, then emit them start to end.
+	TArray<int32>& Chain = Scratch.Queue;
+	int32 Node = BestNode;
+	while (Scratch.Parent[Node] >= 0) {
+		const int32 CorridorIndex = Scratch.Parent[Node];
+		Chain.Add(CorridorIndex);
+		Node = Corridors[CorridorIndex].To == Node ? Corridors[CorridorIndex].From : Corridors[CorridorIndex].To;
+	}
+
+	const FJunctionSeed& Seed = Seeds[-2 - Scratch.Parent[Node]];
+	if (Seed.Corridor == INDEX_NONE) {
+		Path.Add(StartPoint);
+	} else {
+		AppendCorridor(Seed.Corridor, Seed.FirstPosition, Seed.LastPosition, Path);
+	}
+
+	for (int32 i = Chain.Num() - 1; i >= 0; i--) {
+		const FMazeCorridor& Corridor = Corridors[Chain[i]];
+		if (Corridor.From == Node) {
+			AppendCorridor(Chain[i], 1, Corridor.Length, Path);
+			Node = Corridor.To;
+		} else {
+			AppendCorridor(Chain[i], Corridor.Length - 1, 0, Path);
+			Node = Corridor.From;
+		}
+	}
+
+	if (EndNode == INDEX_NONE) {
+		AppendCorridor(EndCorridor, BestEndFirst == 0 ? 1 : BestEndFirst - 1, EndPosition, Path);
+	}
+	return true;
+}
+
+#if WITH_EDITOR
+#include "MazeTestLayouts.h"
+
+namespace
+{
+	/**
+	 * The corridor walk the hop table replaced: step out of Tile in Direction, then keep
+	 * following the only way on until a tile with other than two path neighbors. Appends
+	 * every tile visited, Tile included. Returns false if it walks into a wall or loops.
+	 */
+	bool WalkToJunction(const FMazeTileGrid& Grid, FIntPair Tile, EDirection Direction, TArray<FIntPair>& Walked)
+	{
+		Walked.Add(Tile);
+		for (int32 Steps = 0; Steps <= Grid.Num(); Steps++) {
+			const FIntPair Next = FMazeTileGrid::Step(Tile, Direction);
+			if (!Grid.IsPath(Next.y, Next.x)) {
+				return false;
+			}
+			Walked.Add(Next);
+			Tile = Next;
+
+			int32 Neighbors = 0;
+			EDirection Onward = EDirection::D_None;
+			for (uint8 d = 0; d < 4; d++) {
+				const FIntPair Neighbor = FMazeTileGrid::Step(Tile, (EDirection)d);
+				if (Grid.IsPath(Neighbor.y, Neighbor.x)) {
+					Neighbors++;
+					if (d != OppositeDirection((uint8)Direction)) {
+						Onward = (EDirection)d;
+					}
+				}
+			}
+			if (Neighbors != 2) {
+				return true;
+			}
+			Direction = Onward;
+		}
+		return false;
+	}
+
+	bool SameTiles(const TArray<FIntPair>& A, const TArray<FIntPair>& B)
+	{
+		if (A.Num() != B.Num()) {
+			return false;
+		}
+		for (int32 i = 0; i < A.Num(); i++) {
+			if (A[i].x != B[i].x || A[i].y != B[i].y) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMazeJunctionGraphWalkTest, "ProtoGauntlet.Maze.JunctionGraph.MatchesCorridorWalk", EAutomationTestFlags::ATF_Editor)
+
+bool FMazeJunctionGraphWalkTest::RunTest(const FString& Parameters) {
+	const int32 Seeds[] = { 3, 11, 2024 };
+
+	for (int32 Seed : Seeds) {
+		FMazeRandomStream Random(Seed);
+		FMazeTileGrid Layouts[3];
+		FMazeTestLayouts::MakePerfect(Layouts[0], 31, 25, Random);
+		FMazeTestLayouts::MakePerfect(Layouts[1], 31, 25, Random);
+		FMazeTestLayouts::AddLoops(Layouts[1], 40, Random);
+		FMazeTestLayouts::MakeNoise(Layouts[2], 30, 24, 0.6f, Random);
+
+		for (int32 l = 0; l < ARRAY_COUNT(Layouts); l++) {
+			const FMazeTileGrid& Grid = Layouts[l];
+			FMazeJunctionGraph Graph;
+			Graph.Build(Grid);
+
+			FMazeSearchScratch Scratch;
+			TArray<FIntPair> Walked;
+			TArray<FIntPair> Path;
+			int32 HopMismatches = 0;
+			int32 TileMismatches = 0;
+			for (int32 y = 0; y < Grid.Height; y++) {
+				for (int32 x = 0; x < Grid.Width; x++) {
+					if (!Grid.IsPath(y, x)) {
+						continue;
+					}
+					for (uint8 d = 0; d < 4; d++) {
+						const FIntPair Tile(x, y);
+						Walked.Reset();
+						const bool bWalked = WalkToJunction(Grid, Tile, (EDirection)d, Walked);
+
+						FIntPair Junction;
+						int32 Distance = 0;
+						if (Graph.GetNextJunction(Tile, (EDirection)d, Junction, Distance) != bWalked) {
+							HopMismatches++;
+							continue;
+						}
+						if (!bWalked) {
+							continue;
+						}
+						HopMismatches += Junction != Walked.Last() || Distance != Walked.Num() - 1;
+
+						// Only one route leaves Tile that way, so the graph must replay the corridor's stored tiles exactly.
+						// A corridor that bends back to Tile or its neighbors ends on a tile the start direction rules out.
+						if (FMath::Abs(Junction.x - x) + FMath::Abs(Junction.y - y) <= 1 && Distance > 1) {
+							continue;
+						}
+						Path.Reset();
+						TileMismatches += !Graph.FindPath(Scratch, Tile, Junction, (EDirection)d, Path) || !SameTiles(Path, Walked);
+					}
+				}
+			}
+			TestEqual(FString::Printf(TEXT("Next junctions disagree with the corridor walk (seed %d, layout %d)"), Seed, l), HopMismatches, 0);
+			TestEqual(FString::Printf(TEXT("Corridor tiles disagree with the corridor walk (seed %d, layout %d)"), Seed, l), TileMismatches, 0);
+		}
+	}
+	return true;
+}
+#endif
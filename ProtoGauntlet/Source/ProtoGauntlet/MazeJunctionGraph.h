@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeSearchScratch.h"
+
+/** A corridor between two junctions. Positions run from 0 at From to Length at To. */
+struct FMazeCorridor
+{
+	int32 From;
+
+	int32 To;
+
+	/** Direction leaving From into the corridor. */
+	uint8 FromDirection;
+
+	/** Direction leaving To into the corridor. */
+	uint8 ToDirection;
+
+	/** Steps from From to To. */
+	int32 Length;
+
+	/** Offset of the Length - 1 interior tiles in FMazeJunctionGraph::CorridorTiles, From to To order. */
+	int32 FirstTile;
+};
+
+/** The junction reached by walking from a tile in one direction, and how far away it is. */
+struct FMazeJunctionHop
+{
+	int32 Node;
+
+	int32 Distance;
+
+	FMazeJunctionHop(int32 InNode, int32 InDistance)
+	{
+		Node = InNode;
+		Distance = InDistance;
+	}
+};
+
+/**
+ * Path tiles compressed to a graph. Nodes are junctions: path tiles with other than two
+ * path neighbors, so intersections and dead ends. Edges are the corridors between them.
+ *
+ * Every path tile also stores, per direction, the junction reached by walking that way,
+ * which turns "where is the next intersection" into a table lookup.
+ */
+struct FMazeJunctionGraph
+{
+	FMazeJunctionGraph()
+	{
+		Width = 0;
+		Height = 0;
+	}
+
+	/** Rebuilds nodes, corridors and the per-tile hop table from the path tiles of Grid. */
+	void Build(const FMazeTileGrid& Grid);
+
+	FORCEINLINE bool IsBuilt() const
+	{
+		return Width != 0;
+	}
+
+	/** True if Tile is a junction or lies on a corridor. Loops with no junction are not covered. */
+	FORCEINLINE bool Contains(FIntPair Tile) const
+	{
+		if (Tile.x < 0 || Tile.y < 0 || Tile.x >= Width || Tile.y >= Height) {
+			return false;
+		}
+		const int32 TileIndex = Tile.y * Width + Tile.x;
+		return TileNodes[TileIndex] != INDEX_NONE || TileCorridors[TileIndex] != INDEX_NONE;
+	}
+
+	FORCEINLINE int32 NumJunctions() const
+	{
+		return NodeTiles.Num();
+	}
+
+	FORCEINLINE int32 NumCorridors() const
+	{
+		return Corridors.Num();
+	}
+
+	/**
+	 * The first junction met walking from Tile in Direction, and its distance in steps.
+	 * Returns false if Direction leads into a wall or around a loop with no junctions.
+	 */
+	bool GetNextJunction(FIntPair Tile, EDirection Direction, FIntPair& Junction, int32& Distance) const;
+
+	/**
+	 * Shortest path by A* over junctions, appended from StartPoint to EndPoint inclusive.
+	 * Both points must be covered by the graph. A StartDirection is honored like the tile searches do:
+	 * the other three neighbors of the start are off limits for the whole route.
+	 */
+	bool FindPath(FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) const;
+
+private:
+
+	int32 Width;
+
+	int32 Height;
+
+	/** Tile index of each junction. */
+	TArray<int32> NodeTiles;
+
+	/** Junction at each tile, or INDEX_NONE. */
+	TArray<int32> TileNodes;
+
+	TArray<FMazeCorridor> Corridors;
+
+	/** Interior tiles of every corridor, packed. */
+	TArray<int32> CorridorTiles;
+
+	/** Corridor leaving each junction in each direction, indexed Node * 4 + Direction. */
+	TArray<int32> NodeCorridors;
+
+	/** Corridor holding each interior tile, or INDEX_NONE for junctions and walls. */
+	TArray<int32> TileCorridors;
+
+	/** Position of each interior tile along its corridor. */
+	TArray<int32> TilePositions;
+
+	/** Next junction per tile and direction, indexed TileIndex * 4 + Direction. */
+	TArray<FMazeJunctionHop> Hops;
+
+	FORCEINLINE FIntPair TileToPoint(int32 TileIndex) const
+	{
+		return FIntPair(TileIndex % Width, TileIndex / Width);
+	}
+
+	/** Tile index at Position along Corridor. */
+	FORCEINLINE int32 CorridorTileAt(const FMazeCorridor& Corridor, int32 Position) const
+	{
+		if (Position == 0) {
+			return NodeTiles[Corridor.From];
+		}
+		if (Position == Corridor.Length) {
+			return NodeTiles[Corridor.To];
+		}
+		return CorridorTiles[Corridor.FirstTile + Position - 1];
+	}
+
+	/** Appends the tiles of CorridorIndex from position First to Last inclusive, in that order. */
+	void AppendCorridor(int32 CorridorIndex, int32 First, int32 Last, TArray<FIntPair>& Path) const;
+};
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazePathfinder.h"
+#include "MazeTreeIndex.h"
+#include "MazeJunctionGraph.h"
+
+/**
+ * Frozen copy of a segment's tiles and path caches. Background queries hold it through a
+ * shared pointer, so the segment can rebuild its own layout while they are still running.
+ */
+struct FMazeLayoutSnapshot
+{
+	/** Tiles only; wall references are not copied. */
+	FMazeTileGrid Grid;
+
+	FMazeTreeIndex TreeIndex;
+
+	FMazeJunctionGraph JunctionGraph;
+
+	/** Mostly open ground; deterministic searches use jump point search. */
+	bool bOpenLayout;
+
+	FMazeLayoutSnapshot(const FMazeTileGrid& InGrid, const FMazeTreeIndex& InTreeIndex, const FMazeJunctionGraph& InJunctionGraph, bool bInOpenLayout)
+		: TreeIndex(InTreeIndex)
+		, JunctionGraph(InJunctionGraph)
+		, bOpenLayout(bInOpenLayout)
+	{
+		Grid.Width = InGrid.Width;
+		Grid.Height = InGrid.Height;
+		Grid.Tiles = InGrid.Tiles;
+	}
+
+	FORCEINLINE bool FindPath(FMazeSearchScratch& Scratch, EPathfindingMode Mode, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) const
+	{
+		return FindPathInLayout(Grid, TreeIndex, JunctionGraph, bOpenLayout, Scratch, Mode, StartPoint, EndPoint, StartDirection, Path);
+	}
+
+	/**
+	 * Answers a path query from the cheapest cache that covers it: the tree index for perfect
+	 * mazes, jump point search on open ground, the junction graph when that mode is selected,
+	 * otherwise a grid search. Random depth first is never replaced.
+	 */
+	static bool FindPathInLayout(const FMazeTileGrid& Grid, const FMazeTreeIndex& TreeIndex, const FMazeJunctionGraph& JunctionGraph, bool bOpenLayout, FMazeSearchScratch& Scratch, EPathfindingMode Mode, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path)
+	{
+		if (TreeIndex.IsValid() && TreeIndex.Contains(StartPoint) && TreeIndex.Contains(EndPoint)) {
+			return TreeIndex.FindPath(StartPoint, EndPoint, StartDirection, Path);
+		} else if (bOpenLayout && FMazePathfinder::IsDeterministic(Mode)) {
+			return FMazePathfinder::FindPathJumpPoint(Grid, Scratch, StartPoint, EndPoint, StartDirection, Path);
+		} else if (Mode == EPathfindingMode::PM_JunctionGraph && JunctionGraph.Contains(StartPoint) && JunctionGraph.Contains(EndPoint)) {
+			return JunctionGraph.FindPath(Scratch, StartPoint, EndPoint, StartDirection, Path);
+		} else if (Grid.IsValid(StartPoint.y, StartPoint.x)) {
+			return FMazePathfinder::FindPath(Grid, Scratch, Mode, StartPoint, EndPoint, StartDirection, Path);
+		}
+		return false;
+	}
+};
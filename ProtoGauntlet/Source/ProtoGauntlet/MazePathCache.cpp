@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazePathCache.h"
+
+void FMazePathCache::SetCapacity(int32 InCapacity) {
+	InCapacity = FMath::Max(InCapacity, 0);
+	if (InCapacity < Entries.Num()) {
+		Empty();
+	}
+	Capacity = InCapacity;
+}
+
+const TArray<FIntPair>* FMazePathCache::Find(const FMazePathCacheKey& Key) {
+	const int32* EntryIndex = Lookup.Find(Key);
+	if (!EntryIndex) {
+		Misses++;
+		return nullptr;
+	}
+
+	Hits++;
+	if (*EntryIndex != Head) {
+		Unlink(*EntryIndex);
+		LinkAtHead(*EntryIndex);
+	}
+	return &Entries[*EntryIndex].Path;
+}
+
+void FMazePathCache::Add(const FMazePathCacheKey& Key, const TArray<FIntPair>& Path) {
+	if (Capacity == 0) {
+		return;
+	}
+
+	int32 EntryIndex;
+	if (const int32* Existing = Lookup.Find(Key)) {
+		EntryIndex = *Existing;
+		Unlink(EntryIndex);
+	} else if (Entries.Num() < Capacity) {
+		EntryIndex = Entries.Add(FEntry(Key));
+		Lookup.Add(Key, EntryIndex);
+	} else {
+		// Reuse the least recently used slot, keeping its path buffer.
+		EntryIndex = Tail;
+		Unlink(EntryIndex);
+		Lookup.Remove(Entries[EntryIndex].Key);
+		Entries[EntryIndex].Key = Key;
+		Lookup.Add(Key, EntryIndex);
+	}
+
+	Entries[EntryIndex].Path.Reset();
+	Entries[EntryIndex].Path.Append(Path);
+	LinkAtHead(EntryIndex);
+}
+
+void FMazePathCache::Empty() {
+	Entries.Reset();
+	Lookup.Reset();
+	Head = INDEX_NONE;
+	Tail = INDEX_NONE;
+}
+
+void FMazePathCache::Unlink(int32 EntryIndex) {
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.Prev != INDEX_NONE) {
+		Entries[Entry.Prev].Next = Entry.Next;
+	} else {
+		Head = Entry.Next;
+	}
+	if (Entry.Next != INDEX_NONE) {
+		Entries[Entry.Next].Prev = Entry.Prev;
+	} else {
+		Tail = Entry.Prev;
+	}
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = INDEX_NONE;
+}
+
+void FMazePathCache::LinkAtHead(int32 EntryIndex) {
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = Head;
+	if (Head != INDEX_NONE) {
+		Entries[Head].Prev = EntryIndex;
+	}
+	Head = EntryIndex;
+	if (Tail == INDEX_NONE) {
+		Tail = EntryIndex;
+	}
+}
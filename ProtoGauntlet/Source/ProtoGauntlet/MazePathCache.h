@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MyActor.h"
+
+struct FMazePathCacheKey
+{
+	FIntPair StartPoint;
+
+	FIntPair EndPoint;
+
+	EDirection StartDirection;
+
+	/** Search that found the path. Modes can return different shortest paths of the same length. */
+	EPathfindingMode Mode;
+
+	/** Layout the path was found in. Paths from older layouts never match again and age out. */
+	uint32 LayoutVersion;
+
+	FMazePathCacheKey(FIntPair InStartPoint, FIntPair InEndPoint, EDirection InStartDirection, EPathfindingMode InMode, uint32 InLayoutVersion)
+	{
+		StartPoint = InStartPoint;
+		EndPoint = InEndPoint;
+		StartDirection = InStartDirection;
+		Mode = InMode;
+		LayoutVersion = InLayoutVersion;
+	}
+
+	FORCEINLINE bool operator==(const FMazePathCacheKey& Other) const
+	{
+		return StartPoint.x == Other.StartPoint.x && StartPoint.y == Other.StartPoint.y
+			&& EndPoint.x == Other.EndPoint.x && EndPoint.y == Other.EndPoint.y
+			&& StartDirection == Other.StartDirection && Mode == Other.Mode && LayoutVersion == Other.LayoutVersion;
+	}
+
+	friend FORCEINLINE uint32 GetTypeHash(const FMazePathCacheKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.StartPoint.x), GetTypeHash(Key.StartPoint.y));
+		Hash = HashCombine(Hash, HashCombine(GetTypeHash(Key.EndPoint.x), GetTypeHash(Key.EndPoint.y)));
+		return HashCombine(Hash, HashCombine((uint32)Key.StartDirection | (uint32)Key.Mode << 8, Key.LayoutVersion));
+	}
+};
+
+/**
+ * Bounded least-recently-used store of found paths. Entries sit in a flat array linked
+ * into a recency list by index, so hits and evictions never allocate once the cache is full.
+ * A miss that found no path is worth caching too; store an empty path for it.
+ */
+struct FMazePathCache
+{
+	FMazePathCache()
+	{
+		Capacity = 0;
+		Hits = 0;
+		Misses = 0;
+		Head = INDEX_NONE;
+		Tail = INDEX_NONE;
+	}
+
+	/** Sets the entry limit. Shrinking drops every entry. Zero disables the cache. */
+	void SetCapacity(int32 InCapacity);
+
+	/** The cached path for Key, marked most recently used, or null on a miss. */
+	const TArray<FIntPair>* Find(const FMazePathCacheKey& Key);
+
+	/** Stores Path under Key, evicting the least recently used entry if full. */
+	void Add(const FMazePathCacheKey& Key, const TArray<FIntPair>& Path);
+
+	void Empty();
+
+	FORCEINLINE int32 Num() const
+	{
+		return Lookup.Num();
+	}
+
+	FORCEINLINE int32 GetHits() const
+	{
+		return Hits;
+	}
+
+	FORCEINLINE int32 GetMisses() const
+	{
+		return Misses;
+	}
+
+	void ResetStats()
+	{
+		Hits = 0;
+		Misses = 0;
+	}
+
+private:
+
+	struct FEntry
+	{
+		FMazePathCacheKey Key;
+
+		TArray<FIntPair> Path;
+
+		/** Neighbors in recency order; Prev is more recent. */
+		int32 Prev;
+
+		int32 Next;
+
+		FEntry(const FMazePathCacheKey& InKey)
+			: Key(InKey)
+			, Prev(INDEX_NONE)
+			, Next(INDEX_NONE)
+		{
+		}
+	};
+
+	int32 Capacity;
+
+	int32 Hits;
+
+	int32 Misses;
+
+	/** Most and least recently used entries. */
+	int32 Head;
+
+	int32 Tail;
+
+	TArray<FEntry> Entries;
+
+	TMap<FMazePathCacheKey, int32> Lookup;
+
+	void Unlink(int32 EntryIndex);
+
+	void LinkAtHead(int32 EntryIndex);
+};
@@ -0,0 +1,239 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazePathMasks.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MAZE_MASKS_AVX2 1
+#define MAZE_MASKS_SSE2 0
+#elif defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MAZE_MASKS_AVX2 0
+#define MAZE_MASKS_SSE2 1
+#else
+#define MAZE_MASKS_AVX2 0
+#define MAZE_MASKS_SSE2 0
+#endif
+
+namespace
+{
+	struct FMaskRowPointers
+	{
+		const uint64* Up;
+		const uint64* Mid;
+		const uint64* Down;
+		const uint64* Valid;
+		uint64* Intersection;
+		uint64* Corner;
+		uint64* DeadEnd;
+		uint64* Corridor;
+	};
+
+	// Word w of a row: W/E neighbors come from shifting the row by one bit, carrying the
+	// edge bit in from the neighboring word. Guard words make w - 1 and w + 1 always readable.
+	void ClassifyWordsScalar(const FMaskRowPointers& Rows, int32 First, int32 Last)
+	{
+		for (int32 w = First; w < Last; w++) {
+			const uint64 P = Rows.Mid[w];
+			const uint64 N = Rows.Up[w];
+			const uint64 S = Rows.Down[w];
+			const uint64 W = (P << 1) | (Rows.Mid[w - 1] >> 63);
+			const uint64 E = (P >> 1) | (Rows.Mid[w + 1] << 63);
+			const uint64 Vertical = N | S;
+			const uint64 Horizontal = E | W;
+			const uint64 AtLeastThree = (N & S & Horizontal) | (E & W & Vertical);
+			const uint64 Odd = N ^ S ^ E ^ W;
+			const uint64 Straight = (N & S & ~Horizontal) | (E & W & ~Vertical);
+			const uint64 Valid = Rows.Valid[w];
+
+			Rows.Intersection[w] = AtLeastThree & Valid;
+			Rows.Corner[w] = Vertical & Horizontal & Valid;
+			Rows.DeadEnd[w] = P & Odd & ~AtLeastThree;
+			Rows.Corridor[w] = P & Straight;
+		}
+	}
+
+#if MAZE_MASKS_AVX2
+	int32 ClassifyWordsVector(const FMaskRowPointers& Rows, int32 First, int32 Last)
+	{
+		int32 w = First;
+		for (; w + 4 <= Last; w += 4) {
+			const __m256i P = _mm256_loadu_si256((const __m256i*)(Rows.Mid + w));
+			const __m256i Prev = _mm256_loadu_si256((const __m256i*)(Rows.Mid + w - 1));
+			const __m256i Next = _mm256_loadu_si256((const __m256i*)(Rows.Mid + w + 1));
+			const __m256i N = _mm256_loadu_si256((const __m256i*)(Rows.Up + w));
+			const __m256i S = _mm256_loadu_si256((const __m256i*)(Rows.Down + w));
+			const __m256i Valid = _mm256_loadu_si256((const __m256i*)(Rows.Valid + w));
+			const __m256i W = _mm256_or_si256(_mm256_slli_epi64(P, 1), _mm256_srli_epi64(Prev, 63));
+			const __m256i E = _mm256_or_si256(_mm256_srli_epi64(P, 1), _mm256_slli_epi64(Next, 63));
+			const __m256i Vertical = _mm256_or_si256(N, S);
+			const __m256i Horizontal = _mm256_or_si256(E, W);
+			const __m256i NS = _mm256_and_si256(N, S);
+			const __m256i EW = _mm256_and_si256(E, W);
+			const __m256i AtLeastThree = _mm256_or_si256(_mm256_and_si256(NS, Horizontal), _mm256_and_si256(EW, Vertical));
+			const __m256i Odd = _mm256_xor_si256(_mm256_xor_si256(N, S), _mm256_xor_si256(E, W));
+			const __m256i Straight = _mm256_or_si256(_mm256_andnot_si256(Horizontal, NS), _mm256_andnot_si256(Vertical, EW));
+
+			_mm256_storeu_si256((__m256i*)(Rows.Intersection + w), _mm256_and_si256(AtLeastThree, Valid));
+			_mm256_storeu_si256((__m256i*)(Rows.Corner + w), _mm256_and_si256(_mm256_and_si256(Vertical, Horizontal), Valid));
+			_mm256_storeu_si256((__m256i*)(Rows.DeadEnd + w), _mm256_andnot_si256(AtLeastThree, _mm256_and_si256(P, Odd)));
+			_mm256_storeu_si256((__m256i*)(Rows.Corridor + w), _mm256_and_si256(P, Straight));
+		}
+		return w;
+	}
+#elif MAZE_MASKS_SSE2
+	int32 ClassifyWordsVector(const FMaskRowPointers& Rows, int32 First, int32 Last)
+	{
+		int32 w = First;
+		for (; w + 2 <= Last; w += 2) {
+			const __m128i P = _mm_loadu_si128((const __m128i*)(Rows.Mid + w));
+			const __m128i Prev = _mm_loadu_si128((const __m128i*)(Rows.Mid + w - 1));
+			const __m128i Next = _mm_loadu_si128((const __m128i*)(Rows.Mid + w + 1));
+			const __m128i N = _mm_loadu_si128((const __m128i*)(Rows.Up + w));
+			const __m128i S = _mm_loadu_si128((const __m128i*)(Rows.Down + w));
+			const __m128i Valid = _mm_loadu_si128((const __m128i*)(Rows.Valid + w));
+			const __m128i W = _mm_or_si128(_mm_slli_epi64(P, 1), _mm_srli_epi64(Prev, 63));
+			const __m128i E = _mm_or_si128(_mm_srli_epi64(P, 1), _mm_slli_epi64(Next, 63));
+			const __m128i Vertical = _mm_or_si128(N, S);
+			const __m128i Horizontal = _mm_or_si128(E, W);
+			const __m128i NS = _mm_and_si128(N, S);
+			const __m128i EW = _mm_and_si128(E, W);
+			const __m128i AtLeastThree = _mm_or_si128(_mm_and_si128(NS, Horizontal), _mm_and_si128(EW, Vertical));
+			const __m128i Odd = _mm_xor_si128(_mm_xor_si128(N, S), _mm_xor_si128(E, W));
+			const __m128i Straight = _mm_or_si128(_mm_andnot_si128(Horizontal, NS), _mm_andnot_si128(Vertical, EW));
+
+			_mm_storeu_si128((__m128i*)(Rows.Intersection + w), _mm_and_si128(AtLeastThree, Valid));
+			_mm_storeu_si128((__m128i*)(Rows.Corner + w), _mm_and_si128(_mm_and_si128(Vertical, Horizontal), Valid));
+			_mm_storeu_si128((__m128i*)(Rows.DeadEnd + w), _mm_andnot_si128(AtLeastThree, _mm_and_si128(P, Odd)));
+			_mm_storeu_si128((__m128i*)(Rows.Corridor + w), _mm_and_si128(P, Straight));
+		}
+		return w;
+	}
+#else
+	int32 ClassifyWordsVector(const FMaskRowPointers& Rows, int32 First, int32 Last)
+	{
+		return First;
+	}
+#endif
+}
+
+void FMazePathMasks::Build(const FMazeTileGrid& Grid) {
+	Width = Grid.Width;
+	Height = Grid.Height;
+	DataWords = (Width + 63) / 64;
+	Stride = DataWords + 2;
+
+	const int32 TotalWords = (Height + 2) * Stride;
+	Path.Init(0, TotalWords);
+	Intersection.Init(0, TotalWords);
+	Corner.Init(0, TotalWords);
+	DeadEnd.Init(0, TotalWords);
+	Corridor.Init(0, TotalWords);
+
+	ColumnMask.Init(0, Stride);
+	for (int32 x = 0; x < Width; x++) {
+		ColumnMask[1 + (x >> 6)] |= (uint64)1 << (x & 63);
+	}
+
+	const ETileDesignation* Tiles = Grid.Tiles.GetData();
+	for (int32 y = 0; y < Height; y++) {
+		uint64* RowWords = Path.GetData() + (y + 1) * Stride + 1;
+		for (int32 x = 0; x < Width; x++) {
+			if (Tiles[y * Width + x] == ETileDesignation::TD_Path) {
+				RowWords[x >> 6] |= (uint64)1 << (x & 63);
+			}
+		}
+	}
+
+	FMaskRowPointers Rows;
+	Rows.Valid = ColumnMask.GetData() + 1;
+	for (int32 y = 0; y < Height; y++) {
+		const int32 RowStart = (y + 1) * Stride + 1;
+		Rows.Up = Path.GetData() + RowStart - Stride;
+		Rows.Mid = Path.GetData() + RowStart;
+		Rows.Down = Path.GetData() + RowStart + Stride;
+		Rows.Intersection = Intersection.GetData() + RowStart;
+		Rows.Corner = Corner.GetData() + RowStart;
+		Rows.DeadEnd = DeadEnd.GetData() + RowStart;
+		Rows.Corridor = Corridor.GetData() + RowStart;
+
+		const int32 Remainder = ClassifyWordsVector(Rows, 0, DataWords);
+		ClassifyWordsScalar(Rows, Remainder, DataWords);
+	}
+}
+
+#if WITH_EDITOR
+#include "MazeTestLayouts.h"
+
+namespace
+{
+	// The per-tile rules the masks replaced, kept here as the reference.
+	int32 CountPathNeighbors(const FMazeTileGrid& Grid, int32 TileRow, int32 TileColumn)
+	{
+		return Grid.IsPath(TileRow - 1, TileColumn) + Grid.IsPath(TileRow + 1, TileColumn) + Grid.IsPath(TileRow, TileColumn - 1) + Grid.IsPath(TileRow, TileColumn + 1);
+	}
+
+	bool IsIntersectionScalar(const FMazeTileGrid& Grid, int32 TileRow, int32 TileColumn)
+	{
+		return CountPathNeighbors(Grid, TileRow, TileColumn) >= 3;
+	}
+
+	bool IsCornerScalar(const FMazeTileGrid& Grid, int32 TileRow, int32 TileColumn)
+	{
+		return (Grid.IsPath(TileRow - 1, TileColumn) || Grid.IsPath(TileRow + 1, TileColumn))
+			&& (Grid.IsPath(TileRow, TileColumn - 1) || Grid.IsPath(TileRow, TileColumn + 1));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMazePathMasksScalarTest, "ProtoGauntlet.Maze.PathMasks.MatchesScalar", EAutomationTestFlags::ATF_Editor)
+
+bool FMazePathMasksScalarTest::RunTest(const FString& Parameters) {
+	// Widths either side of the 64-bit word and of the two- and four-word vector steps.
+	const int32 Widths[] = { 5, 63, 64, 65, 127, 128, 129, 200, 257, 300 };
+	const int32 Repeats = 20;
+	FMazeRandomStream Random(0x51D);
+
+	for (int32 Width : Widths) {
+		FMazeTileGrid Grid;
+		FMazeTestLayouts::MakeNoise(Grid, Width, 61, 0.55f, Random);
+
+		FMazePathMasks Masks;
+		Masks.Build(Grid);
+		int32 Mismatches = 0;
+		for (int32 y = 0; y < Grid.Height; y++) {
+			for (int32 x = 0; x < Grid.Width; x++) {
+				const int32 Neighbors = CountPathNeighbors(Grid, y, x);
+				const bool bPath = Grid.IsPath(y, x);
+				Mismatches += Masks.IsPath(y, x) != bPath;
+				Mismatches += Masks.IsIntersection(y, x) != IsIntersectionScalar(Grid, y, x);
+				Mismatches += Masks.IsCorner(y, x) != IsCornerScalar(Grid, y, x);
+				Mismatches += Masks.IsDeadEnd(y, x) != (bPath && Neighbors == 1);
+			}
+		}
+		TestEqual(FString::Printf(TEXT("Mask bits disagree with the scalar rules at width %d"), Width), Mismatches, 0);
+		TestFalse(FString::Printf(TEXT("Column past width %d classified"), Width), Masks.IsIntersection(0, Width) || Masks.IsCorner(0, Width));
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Repeats; i++) {
+			Masks.Build(Grid);
+		}
+		const double MaskSeconds = FPlatformTime::Seconds() - StartTime;
+
+		int32 Classified = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Repeats; i++) {
+			for (int32 y = 0; y < Grid.Height; y++) {
+				for (int32 x = 0; x < Grid.Width; x++) {
+					Classified += IsIntersectionScalar(Grid, y, x) + IsCornerScalar(Grid, y, x);
+				}
+			}
+		}
+		const double ScalarSeconds = FPlatformTime::Seconds() - StartTime;
+
+		AddLogItem(FString::Printf(TEXT("%dx%d: masks %.3f ms, scalar %.3f ms per classification (%d hits)"),
+			Grid.Width, Grid.Height, MaskSeconds * 1000.0 / Repeats, ScalarSeconds * 1000.0 / Repeats, Classified / Repeats));
+	}
+	return true;
+}
+#endif
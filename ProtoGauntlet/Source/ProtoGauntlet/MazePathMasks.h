@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeTileGrid.h"
+
+/**
+ * Bitboard view of a maze segment, one bit per tile for "is path", plus neighbor
+ * classification masks computed for the whole grid in one pass.
+ *
+ * Each row is stored as 64-bit words with one zero guard word on either side, and
+ * the grid has a zero guard row above and below, so the shifted-word kernels never
+ * need bounds checks.
+ */
+struct FMazePathMasks
+{
+	FMazePathMasks()
+	{
+		Width = 0;
+		Height = 0;
+		DataWords = 0;
+		Stride = 0;
+	}
+
+	/** Rebuilds the path bitboard from Grid and reclassifies every tile. */
+	void Build(const FMazeTileGrid& Grid);
+
+	/** At least three path neighbors. Matches AMazeSegment::IsIntersection. */
+	FORCEINLINE bool IsIntersection(int32 TileRow, int32 TileColumn) const
+	{
+		return TestBit(Intersection, TileRow, TileColumn);
+	}
+
+	/** A path neighbor on both axes. Matches AMazeSegment::IsCorner. */
+	FORCEINLINE bool IsCorner(int32 TileRow, int32 TileColumn) const
+	{
+		return TestBit(Corner, TileRow, TileColumn);
+	}
+
+	/** A path tile with exactly one path neighbor. */
+	FORCEINLINE bool IsDeadEnd(int32 TileRow, int32 TileColumn) const
+	{
+		return TestBit(DeadEnd, TileRow, TileColumn);
+	}
+
+	/** A path tile with exactly two opposite path neighbors. */
+	FORCEINLINE bool IsCorridor(int32 TileRow, int32 TileColumn) const
+	{
+		return TestBit(Corridor, TileRow, TileColumn);
+	}
+
+	FORCEINLINE bool IsPath(int32 TileRow, int32 TileColumn) const
+	{
+		return TestBit(Path, TileRow, TileColumn);
+	}
+
+	FORCEINLINE bool IsBuilt() const
+	{
+		return Stride != 0;
+	}
+
+private:
+
+	int32 Width;
+
+	int32 Height;
+
+	/** Words holding tile bits in a row, excluding the guard words. */
+	int32 DataWords;
+
+	/** Words per stored row, including the guard words. */
+	int32 Stride;
+
+	/** Valid column bits per row word, so columns past Width never classify. */
+	TArray<uint64> ColumnMask;
+
+	TArray<uint64> Path;
+
+	TArray<uint64> Intersection;
+
+	TArray<uint64> Corner;
+
+	TArray<uint64> DeadEnd;
+
+	TArray<uint64> Corridor;
+
+	FORCEINLINE bool TestBit(const TArray<uint64>& Mask, int32 TileRow, int32 TileColumn) const
+	{
+		if (TileColumn < 0 || TileRow < 0 || TileColumn >= Width || TileRow >= Height) {
+			return false;
+		}
+		return ((Mask[(TileRow + 1) * Stride + 1 + (TileColumn >> 6)] >> (TileColumn & 63)) & 1) != 0;
+	}
+};
@@ -0,0 +1,452 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazePathfinder.h"
+
+namespace
+{
+	// Indexed by EDirection: North, East, South, West.
+	const int32 DirectionRowDelta[4] = { -1, 0, 1, 0 };
+	const int32 DirectionColumnDelta[4] = { 0, 1, 0, -1 };
+
+	FORCEINLINE int32 ManhattanDistance(int32 RowA, int32 ColumnA, int32 RowB, int32 ColumnB)
+	{
+		return FMath::Abs(RowA - RowB) + FMath::Abs(ColumnA - ColumnB);
+	}
+
+	/**
+	 * Straight line scans for four-connected jump point search. Canonical paths run vertically
+	 * first, so a vertical scan spawns horizontal scans from every tile it crosses, while a
+	 * horizontal scan only stops where a wall behind it forces a turn. Tiles the scratch has
+	 * already visited (the start and any tiles blocked by a heading) count as walls.
+	 */
+	struct FJumpScanner
+	{
+		const FMazeTileGrid& Grid;
+
+		const FMazeSearchScratch& Scratch;
+
+		int32 EndIndex;
+
+		FJumpScanner(const FMazeTileGrid& InGrid, const FMazeSearchScratch& InScratch, int32 InEndIndex)
+			: Grid(InGrid)
+			, Scratch(InScratch)
+			, EndIndex(InEndIndex)
+		{
+		}
+
+		FORCEINLINE bool IsWalkable(int32 Row, int32 Column) const
+		{
+			return Scratch.IsOpen(Grid, Row, Column);
+		}
+
+		/** A turn off a horizontal run is forced where the tile beside it is open but the one behind that is not. */
+		FORCEINLINE bool HasForcedTurn(int32 Row, int32 Column, int32 ColumnStep) const
+		{
+			return (IsWalkable(Row - 1, Column) && !IsWalkable(Row - 1, Column - ColumnStep))
+				|| (IsWalkable(Row + 1, Column) && !IsWalkable(Row + 1, Column - ColumnStep));
+		}
+
+		int32 JumpHorizontal(int32 Row, int32 Column, int32 ColumnStep) const
+		{
+			for (;;) {
+				Column += ColumnStep;
+				if (!IsWalkable(Row, Column)) {
+					return INDEX_NONE;
+				}
+
+				const int32 TileIndex = Grid.Index(Row, Column);
+				if (TileIndex == EndIndex || HasForcedTurn(Row, Column, ColumnStep)) {
+					return TileIndex;
+				}
+			}
+		}
+
+		int32 JumpVertical(int32 Row, int32 Column, int32 RowStep) const
+		{
+			for (;;) {
+				Row += RowStep;
+				if (!IsWalkable(Row, Column)) {
+					return INDEX_NONE;
+				}
+
+				const int32 TileIndex = Grid.Index(Row, Column);
+				if (TileIndex == EndIndex || JumpHorizontal(Row, Column, 1) != INDEX_NONE || JumpHorizontal(Row, Column, -1) != INDEX_NONE) {
+					return TileIndex;
+				}
+			}
+		}
+	};
+}
+
+bool FMazePathfinder::FindPath(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, EPathfindingMode Mode, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) {
+	switch (Mode) {
+	case EPathfindingMode::PM_BreadthFirst:
+		return FindPathBreadthFirst(Grid, Scratch, StartPoint, EndPoint, StartDirection, Path);
+	case EPathfindingMode::PM_AStar:
+	case EPathfindingMode::PM_JunctionGraph:
+		// Junction graph searches need the segment's graph; on a bare grid they are plain A*.
+		return FindPathAStar(Grid, Scratch, StartPoint, EndPoint, StartDirection, Path);
+	default:
+		return FindPathRandomDepthFirst(Grid, Scratch, StartPoint, EndPoint, StartDirection, Path);
+	}
+}
+
+bool FMazePathfinder::BeginSearch(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, EDirection StartDirection) {
+	Scratch.Begin(Grid.Num());
+	Scratch.Visit(Grid.Index(StartPoint.y, StartPoint.x));
+
+	if (StartDirection != EDirection::D_None) {
+		return Scratch.BlockAllButHeading(Grid, StartPoint, StartDirection);
+	}
+	return true;
+}
+
+void FMazePathfinder::AppendParentChain(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, int32 EndIndex, TArray<FIntPair>& Path) {
+	TArray<FIntPair>& Reversed = Scratch.Stack;
+	Reversed.Reset();
+	for (int32 TileIndex = EndIndex; TileIndex != INDEX_NONE; TileIndex = Scratch.Parent[TileIndex]) {
+		Reversed.Add(FIntPair(TileIndex % Grid.Width, TileIndex / Grid.Width));
+	}
+
+	Path.Reserve(Path.Num() + Reversed.Num());
+	for (int32 i = Reversed.Num() - 1; i >= 0; i--) {
+		Path.Add(Reversed[i]);
+	}
+}
+
+bool FMazePathfinder::FindPathRandomDepthFirst(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) {
+	if (!Grid.IsValid(StartPoint.y, StartPoint.x) || !BeginSearch(Grid, Scratch, StartPoint, StartDirection)) {
+		return false;
+	}
+
+	TArray<FIntPair>& PathStack = Scratch.Stack;
+	PathStack.Add(StartPoint);
+
+	FMazeNeighborArray ValidNeighbors;
+	FIntPair StackHead = StartPoint;
+	while (PathStack.Num() != 0 && PathStack.Last() != EndPoint) {
+		Scratch.GetOpenNeighbors(Grid, StackHead, ValidNeighbors);
+
+		if (ValidNeighbors.Num() != 0) {
+			// Choose random valid neighbor
+			StackHead = ValidNeighbors[Scratch.Random.RandRange(0, ValidNeighbors.Num() - 1)];
+			Scratch.Visit(Grid.Index(StackHead.y, StackHead.x));
+			PathStack.Push(StackHead);
+		} else {
+			PathStack.Pop();
+			if (PathStack.Num() != 0) {
+				StackHead = PathStack.Last();
+			}
+		}
+	}
+
+	Path.Append(PathStack);
+	return PathStack.Num() != 0;
+}
+
+bool FMazePathfinder::FindPathBreadthFirst(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) {
+	if (!Grid.IsValid(StartPoint.y, StartPoint.x) || !Grid.IsValid(EndPoint.y, EndPoint.x) || !BeginSearch(Grid, Scratch, StartPoint, StartDirection)) {
+		return false;
+	}
+
+	const int32 StartIndex = Grid.Index(StartPoint.y, StartPoint.x);
+	const int32 EndIndex = Grid.Index(EndPoint.y, EndPoint.x);
+	if (StartIndex != EndIndex && Grid.Tiles[EndIndex] != ETileDesignation::TD_Path) {
+		return false;
+	}
+	Scratch.Discover(StartIndex, 0, INDEX_NONE);
+	if (StartIndex == EndIndex) {
+		Path.Add(StartPoint);
+		return true;
+	}
+
+	TArray<int32>& Queue = Scratch.Queue;
+	Queue.Add(StartIndex);
+	for (int32 Head = 0; Head < Queue.Num(); Head++) {
+		const int32 Current = Queue[Head];
+		const int32 CurrentRow = Current / Grid.Width;
+		const int32 CurrentColumn = Current % Grid.Width;
+
+		for (int32 Direction = 0; Direction < 4; Direction++) {
+			const int32 NeighborRow = CurrentRow + DirectionRowDelta[Direction];
+			const int32 NeighborColumn = CurrentColumn + DirectionColumnDelta[Direction];
+			if (!Scratch.IsOpen(Grid, NeighborRow, NeighborColumn)) {
+				continue;
+			}
+
+			const int32 NeighborIndex = Grid.Index(NeighborRow, NeighborColumn);
+			Scratch.Visit(NeighborIndex);
+			Scratch.Discover(NeighborIndex, Scratch.Cost[Current] + 1, Current);
+			if (NeighborIndex == EndIndex) {
+				AppendParentChain(Grid, Scratch, EndIndex, Path);
+				return true;
+			}
+			Queue.Add(NeighborIndex);
+		}
+	}
+	return false;
+}
+
+bool FMazePathfinder::FindPathAStar(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) {
+	if (!Grid.IsValid(StartPoint.y, StartPoint.x) || !Grid.IsValid(EndPoint.y, EndPoint.x) || !BeginSearch(Grid, Scratch, StartPoint, StartDirection)) {
+		return false;
+	}
+
+	const int32 StartIndex = Grid.Index(StartPoint.y, StartPoint.x);
+	const int32 EndIndex = Grid.Index(EndPoint.y, EndPoint.x);
+	if (StartIndex != EndIndex && Grid.Tiles[EndIndex] != ETileDesignation::TD_Path) {
+		return false;
+	}
+	TArray<FMazeOpenNode>& Open = Scratch.Open;
+	Scratch.Discover(StartIndex, 0, INDEX_NONE);
+	Open.HeapPush(FMazeOpenNode(ManhattanDistance(StartPoint.y, StartPoint.x, EndPoint.y, EndPoint.x), 0, StartIndex), TLess<FMazeOpenNode>());
+
+	FMazeOpenNode Node(0, 0, INDEX_NONE);
+	while (Open.Num() != 0) {
+		Open.HeapPop(Node, TLess<FMazeOpenNode>(), false);
+
+		// A cheaper route to this tile was queued after this entry; the entry is stale.
+		if (Node.Cost != Scratch.Cost[Node.TileIndex]) {
+			continue;
+		}
+
+		if (Node.TileIndex == EndIndex) {
+			AppendParentChain(Grid, Scratch, EndIndex, Path);
+			return true;
+		}
+
+		const int32 CurrentRow = Node.TileIndex / Grid.Width;
+		const int32 CurrentColumn = Node.TileIndex % Grid.Width;
+		const int32 NeighborCost = Node.Cost + 1;
+
+		for (int32 Direction = 0; Direction < 4; Direction++) {
+			const int32 NeighborRow = CurrentRow + DirectionRowDelta[Direction];
+			const int32 NeighborColumn = CurrentColumn + DirectionColumnDelta[Direction];
+			if (!Scratch.IsOpen(Grid, NeighborRow, NeighborColumn)) {
+				continue;
+			}
+
+			const int32 NeighborIndex = Grid.Index(NeighborRow, NeighborColumn);
+			if (Scratch.IsDiscovered(NeighborIndex) && Scratch.Cost[NeighborIndex] <= NeighborCost) {
+				continue;
+			}
+
+			Scratch.Discover(NeighborIndex, NeighborCost, Node.TileIndex);
+			Open.HeapPush(FMazeOpenNode(NeighborCost + ManhattanDistance(NeighborRow, NeighborColumn, EndPoint.y, EndPoint.x), NeighborCost, NeighborIndex), TLess<FMazeOpenNode>());
+		}
+	}
+	return false;
+}
+
+bool FMazePathfinder::FindPathJumpPoint(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) {
+	if (!Grid.IsValid(StartPoint.y, StartPoint.x) || !Grid.IsValid(EndPoint.y, EndPoint.x) || !BeginSearch(Grid, Scratch, StartPoint, StartDirection)) {
+		return false;
+	}
+
+	const int32 StartIndex = Grid.Index(StartPoint.y, StartPoint.x);
+	const int32 EndIndex = Grid.Index(EndPoint.y, EndPoint.x);
+	if (StartIndex == EndIndex) {
+		Path.Add(StartPoint);
+		return true;
+	}
+	if (Grid.Tiles[EndIndex] != ETileDesignation::TD_Path) {
+		return false;
+	}
+
+	const FJumpScanner Scanner(Grid, Scratch, EndIndex);
+	TArray<FMazeOpenNode>& Open = Scratch.Open;
+	Scratch.Discover(StartIndex, 0, INDEX_NONE);
+	Open.HeapPush(FMazeOpenNode(ManhattanDistance(StartPoint.y, StartPoint.x, EndPoint.y, EndPoint.x), 0, StartIndex), TLess<FMazeOpenNode>());
+
+	int32 Successors[4];
+	FMazeOpenNode Node(0, 0, INDEX_NONE);
+	while (Open.Num() != 0) {
+		Open.HeapPop(Node, TLess<FMazeOpenNode>(), false);
+		if (Node.Cost != Scratch.Cost[Node.TileIndex]) {
+			continue;
+		}
+
+		if (Node.TileIndex == EndIndex) {
+			// Parents are jump points in straight lines from each other; fill in the tiles between.
+			TArray<FIntPair>& JumpPoints = Scratch.Stack;
+			JumpPoints.Reset();
+			for (int32 TileIndex = EndIndex; TileIndex != INDEX_NONE; TileIndex = Scratch.Parent[TileIndex]) {
+				JumpPoints.Add(FIntPair(TileIndex % Grid.Width, TileIndex / Grid.Width));
+			}
+
+			Path.Reserve(Path.Num() + Node.Cost + 1);
+			Path.Add(StartPoint);
+			for (int32 i = JumpPoints.Num() - 2; i >= 0; i--) {
+				FIntPair Tile = JumpPoints[i + 1];
+				const int32 ColumnStep = FMath::Sign(JumpPoints[i].x - Tile.x);
+				const int32 RowStep = FMath::Sign(JumpPoints[i].y - Tile.y);
+				while (Tile != JumpPoints[i]) {
+					Tile.x += ColumnStep;
+					Tile.y += RowStep;
+					Path.Add(Tile);
+				}
+			}
+			return true;
+		}
+
+		const int32 CurrentRow = Node.TileIndex / Grid.Width;
+		const int32 CurrentColumn = Node.TileIndex % Grid.Width;
+		const int32 Parent = Scratch.Parent[Node.TileIndex];
+		int32 NumSuccessors = 0;
+
+		if (Parent == INDEX_NONE) {
+			// The start scans every way; BeginSearch has already walled off all but the heading.
+			Successors[NumSuccessors++] = Scanner.JumpVertical(CurrentRow, CurrentColumn, -1);
+			Successors[NumSuccessors++] = Scanner.JumpVertical(CurrentRow, CurrentColumn, 1);
+			Successors[NumSuccessors++] = Scanner.JumpHorizontal(CurrentRow, CurrentColumn, 1);
+			Successors[NumSuccessors++] = Scanner.JumpHorizontal(CurrentRow, CurrentColumn, -1);
+		} else if (Parent % Grid.Width == CurrentColumn) {
+			// Arrived vertically: carry on, and branch both ways horizontally.
+			const int32 RowStep = CurrentRow > Parent / Grid.Width ? 1 : -1;
+			Successors[NumSuccessors++] = Scanner.JumpVertical(CurrentRow, CurrentColumn, RowStep);
+			Successors[NumSuccessors++] = Scanner.JumpHorizontal(CurrentRow, CurrentColumn, 1);
+			Successors[NumSuccessors++] = Scanner.JumpHorizontal(CurrentRow, CurrentColumn, -1);
+		} else {
+			// Arrived horizontally: carry on, and turn only where a wall behind forces it.
+			const int32 ColumnStep = CurrentColumn > Parent % Grid.Width ? 1 : -1;
+			Successors[NumSuccessors++] = Scanner.JumpHorizontal(CurrentRow, CurrentColumn, ColumnStep);
+			for (int32 RowStep = -1; RowStep <= 1; RowStep += 2) {
+				if (Scanner.IsWalkable(CurrentRow + RowStep, CurrentColumn) && !Scanner.IsWalkable(CurrentRow + RowStep, CurrentColumn - ColumnStep)) {
+					Successors[NumSuccessors++] = Scanner.JumpVertical(CurrentRow, CurrentColumn, RowStep);
+				}
+			}
+		}
+
+		for (int32 i = 0; i < NumSuccessors; i++) {
+			const int32 Successor = Successors[i];
+			if (Successor == INDEX_NONE) {
+				continue;
+			}
+
+			const int32 SuccessorRow = Successor / Grid.Width;
+			const int32 SuccessorColumn = Successor % Grid.Width;
+			const int32 SuccessorCost = Node.Cost + ManhattanDistance(CurrentRow, CurrentColumn, SuccessorRow, SuccessorColumn);
+			if (Scratch.IsDiscovered(Successor) && Scratch.Cost[Successor] <= SuccessorCost) {
+				continue;
+			}
+
+			Scratch.Discover(Successor, SuccessorCost, Node.TileIndex);
+			Open.HeapPush(FMazeOpenNode(SuccessorCost + ManhattanDistance(SuccessorRow, SuccessorColumn, EndPoint.y, EndPoint.x), SuccessorCost, Successor), TLess<FMazeOpenNode>());
+		}
+	}
+	return false;
+}
+
+float FMazePathfinder::MeasureOpenness(const FMazeTileGrid& Grid) {
+	if (Grid.Width < 2 || Grid.Height < 2) {
+		return 0.f;
+	}
+
+	int32 OpenBlocks = 0;
+	for (int32 Row = 0; Row + 1 < Grid.Height; Row++) {
+		const ETileDesignation* Upper = Grid.Tiles.GetData() + Row * Grid.Width;
+		const ETileDesignation* Lower = Upper + Grid.Width;
+		for (int32 Column = 0; Column + 1 < Grid.Width; Column++) {
+			if (Upper[Column] == ETileDesignation::TD_Path && Upper[Column + 1] == ETileDesignation::TD_Path
+				&& Lower[Column] == ETileDesignation::TD_Path && Lower[Column + 1] == ETileDesignation::TD_Path) {
+				OpenBlocks++;
+			}
+		}
+	}
+	return (float)OpenBlocks / (float)((Grid.Width - 1) * (Grid.Height - 1));
+}
+
+#if WITH_EDITOR
+#include "MazeTestLayouts.h"
+
+namespace
+{
+	/** Steps in a path, or INDEX_NONE if it is empty, leaves the path tiles, or jumps between tiles. */
+	int32 CheckedLength(const FMazeTileGrid& Grid, const TArray<FIntPair>& Path)
+	{
+		if (Path.Num() == 0) {
+			return INDEX_NONE;
+		}
+		for (int32 i = 0; i < Path.Num(); i++) {
+			if (!Grid.IsPath(Path[i].y, Path[i].x)) {
+				return INDEX_NONE;
+			}
+			if (i > 0 && FMath::Abs(Path[i].x - Path[i - 1].x) + FMath::Abs(Path[i].y - Path[i - 1].y) != 1) {
+				return INDEX_NONE;
+			}
+		}
+		return Path.Num() - 1;
+	}
+
+	/** Square rings of wall around the center, each with a few gaps, like an arena part way through expanding. */
+	void MakeRings(FMazeTileGrid& Grid, int32 Size, FMazeRandomStream& Random)
+	{
+		Grid.Init(Size, Size, ETileDesignation::TD_Path);
+		const int32 Center = Size / 2;
+		for (int32 Ring = 3; Ring < Center; Ring += 4) {
+			for (int32 i = -Ring; i <= Ring; i++) {
+				Grid.Set(Center - Ring, Center + i, ETileDesignation::TD_Wall);
+				Grid.Set(Center + Ring, Center + i, ETileDesignation::TD_Wall);
+				Grid.Set(Center + i, Center - Ring, ETileDesignation::TD_Wall);
+				Grid.Set(Center + i, Center + Ring, ETileDesignation::TD_Wall);
+			}
+			for (int32 Gap = 0; Gap < 3; Gap++) {
+				const int32 Offset = Random.RandRange(-Ring + 1, Ring - 1);
+				switch (Random.RandRange(0, 3)) {
+				case 0: Grid.Set(Center - Ring, Center + Offset, ETileDesignation::TD_Path); break;
+				case 1: Grid.Set(Center + Ring, Center + Offset, ETileDesignation::TD_Path); break;
+				case 2: Grid.Set(Center + Offset, Center - Ring, ETileDesignation::TD_Path); break;
+				default: Grid.Set(Center + Offset, Center + Ring, ETileDesignation::TD_Path); break;
+				}
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMazeJumpPointLengthTest, "ProtoGauntlet.Maze.Pathfinder.JumpPointMatchesAStar", EAutomationTestFlags::ATF_Editor)
+
+bool FMazeJumpPointLengthTest::RunTest(const FString& Parameters) {
+	const float WallChances[] = { 0.f, 0.05f, 0.15f, 0.3f };
+	const int32 PairsPerLayout = 150;
+	FMazeRandomStream Random(0x3B5);
+	FMazeSearchScratch Scratch;
+	TArray<FIntPair> Path;
+
+	for (int32 l = 0; l <= ARRAY_COUNT(WallChances); l++) {
+		FMazeTileGrid Grid;
+		if (l < ARRAY_COUNT(WallChances)) {
+			FMazeTestLayouts::MakeOpen(Grid, 61, 47, WallChances[l], Random);
+		}
+		else {
+			MakeRings(Grid, 63, Random);
+		}
+
+		int32 Mismatches = 0;
+		double AStarSeconds = 0.0;
+		double JumpPointSeconds = 0.0;
+		for (int32 i = 0; i < PairsPerLayout; i++) {
+			const FIntPair Start = FMazeTestLayouts::RandomPathTile(Grid, Random);
+			const FIntPair End = FMazeTestLayouts::RandomPathTile(Grid, Random);
+			// Every fourth query commits to a first step, which both searches must honor.
+			const EDirection StartDirection = i % 4 == 0 ? (EDirection)Random.RandRange(0, 3) : EDirection::D_None;
+
+			Path.Reset();
+			double StartTime = FPlatformTime::Seconds();
+			FMazePathfinder::FindPathAStar(Grid, Scratch, Start, End, StartDirection, Path);
+			AStarSeconds += FPlatformTime::Seconds() - StartTime;
+			const int32 Expected = CheckedLength(Grid, Path);
+
+			Path.Reset();
+			StartTime = FPlatformTime::Seconds();
+			FMazePathfinder::FindPathJumpPoint(Grid, Scratch, Start, End, StartDirection, Path);
+			JumpPointSeconds += FPlatformTime::Seconds() - StartTime;
+			Mismatches += CheckedLength(Grid, Path) != Expected;
+		}
+		TestEqual(FString::Printf(TEXT("Jump point lengths disagree with A* on layout %d"), l), Mismatches, 0);
+		AddLogItem(FString::Printf(TEXT("Layout %d (openness %.2f): A* %.1f us, jump point %.1f us per query"),
+			l, FMazePathfinder::MeasureOpenness(Grid), AStarSeconds * 1e6 / PairsPerLayout, JumpPointSeconds * 1e6 / PairsPerLayout));
+	}
+	return true;
+}
+#endif
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeSearchScratch.h"
+
+/**
+ * Point to point searches over a maze tile grid. Only TD_Path tiles are walkable, apart
+ * from the start tile itself. Every search honors a StartDirection heading the same way:
+ * the three other neighbors of the start are blocked for the whole search.
+ *
+ * All functions only read the grid, so any number of searches may run at once as long
+ * as each uses its own scratch. A found path is appended to Path from StartPoint to
+ * EndPoint inclusive; nothing is appended when there is no path.
+ */
+struct FMazePathfinder
+{
+	static bool FindPath(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, EPathfindingMode Mode, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path);
+
+	/** Randomized depth-first search, drawing from the scratch's stream. Finds a path, not necessarily a short one. */
+	static bool FindPathRandomDepthFirst(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path);
+
+	/** Shortest path by breadth-first search. */
+	static bool FindPathBreadthFirst(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path);
+
+	/** Shortest path by A* with a Manhattan distance heuristic and a binary heap open list. */
+	static bool FindPathAStar(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path);
+
+	/**
+	 * Shortest path by Jump Point Search adapted to four-connected moves. Straight runs are
+	 * scanned without queueing the tiles along them, so open ground costs a handful of heap
+	 * operations instead of one per tile. In corridor mazes nearly every tile is a jump point
+	 * and plain A* is cheaper.
+	 */
+	static bool FindPathJumpPoint(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path);
+
+	/** Fraction of 2x2 tile blocks that are entirely path. Zero for any perfect maze, one for an empty field. */
+	static float MeasureOpenness(const FMazeTileGrid& Grid);
+
+	FORCEINLINE static bool IsDeterministic(EPathfindingMode Mode)
+	{
+		return Mode != EPathfindingMode::PM_RandomDepthFirst;
+	}
+
+private:
+
+	/** Begins a search from StartPoint. Returns false if the heading rules out every move. */
+	static bool BeginSearch(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, FIntPair StartPoint, EDirection StartDirection);
+
+	/** Appends the Parent chain ending at EndIndex to Path, in start to end order. */
+	static void AppendParentChain(const FMazeTileGrid& Grid, FMazeSearchScratch& Scratch, int32 EndIndex, TArray<FIntPair>& Path);
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Small, fast PCG32 generator (64-bit LCG state, permuted 32-bit output). Each segment
+ * owns its own, so layouts replay exactly from a seed and several segments can generate
+ * at once without touching the global FMath stream.
+ */
+struct FMazeRandomStream
+{
+	FMazeRandomStream()
+	{
+		Initialize(0);
+	}
+
+	explicit FMazeRandomStream(uint64 Seed, uint64 Sequence = 0)
+	{
+		Initialize(Seed, Sequence);
+	}
+
+	/** Restarts the stream. Different sequences from one seed give independent streams. */
+	void Initialize(uint64 Seed, uint64 Sequence = 0)
+	{
+		State = 0;
+		Increment = (Sequence << 1) | 1;
+		GetUInt32();
+		State += Seed;
+		GetUInt32();
+	}
+
+	FORCEINLINE uint32 GetUInt32()
+	{
+		const uint64 OldState = State;
+		State = OldState * 6364136223846793005ULL + Increment;
+		const uint32 XorShifted = (uint32)(((OldState >> 18) ^ OldState) >> 27);
+		const uint32 Rotation = (uint32)(OldState >> 59);
+		return (XorShifted >> Rotation) | (XorShifted << ((0u - Rotation) & 31));
+	}
+
+	/** Uniform integer in [Min, Max], without modulo bias. */
+	int32 RandRange(int32 Min, int32 Max)
+	{
+		if (Max <= Min) {
+			return Min;
+		}
+
+		const uint32 Range = (uint32)Max - (uint32)Min + 1;
+		if (Range == 0) {
+			return (int32)GetUInt32();
+		}
+
+		// Reject the few low draws that would make some remainders more likely than others.
+		const uint32 Threshold = (0u - Range) % Range;
+		for (;;) {
+			const uint32 Value = GetUInt32();
+			if (Value >= Threshold) {
+				return (int32)((uint32)Min + Value % Range);
+			}
+		}
+	}
+
+	/** Uniform float in [0, 1). */
+	FORCEINLINE float FRand()
+	{
+		return (float)(GetUInt32() >> 8) * (1.f / 16777216.f);
+	}
+
+	/**
+	 * Scrambles a base seed with an index (SplitMix64), so neighboring indices get unrelated
+	 * seeds. Never returns zero, which the actors read as "pick a fresh seed".
+	 */
+	static int32 DeriveSeed(int32 BaseSeed, int32 Index)
+	{
+		uint64 Mixed = ((uint64)(uint32)BaseSeed << 32 | (uint32)Index) + 0x9E3779B97F4A7C15ULL;
+		Mixed = (Mixed ^ (Mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		Mixed = (Mixed ^ (Mixed >> 27)) * 0x94D049BB133111EBULL;
+		Mixed ^= Mixed >> 31;
+		const int32 Seed = (int32)(uint32)Mixed;
+		return Seed != 0 ? Seed : 1;
+	}
+
+private:
+
+	uint64 State;
+
+	/** Selects the sequence; always odd. */
+	uint64 Increment;
+};
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeTileGrid.h"
+#include "MazeRandomStream.h"
+
+/** Up to four neighbors of a tile, stored inline so gathering them never allocates. */
+typedef TArray<FIntPair, TInlineAllocator<4>> FMazeNeighborArray;
+
+/** Open list entry for best-first searches. */
+struct FMazeOpenNode
+{
+	int32 Estimate;
+
+	int32 Cost;
+
+	int32 TileIndex;
+
+	FMazeOpenNode(int32 InEstimate, int32 InCost, int32 InTileIndex)
+	{
+		Estimate = InEstimate;
+		Cost = InCost;
+		TileIndex = InTileIndex;
+	}
+
+	/** Lowest estimate first; among equal estimates prefer the node furthest along. */
+	FORCEINLINE bool operator<(const FMazeOpenNode& Other) const
+	{
+		return Estimate < Other.Estimate || (Estimate == Other.Estimate && Cost > Other.Cost);
+	}
+};
+
+/**
+ * Reusable working memory for grid searches. Visited tiles are tracked with generation
+ * stamps, so starting a new search is O(1) instead of copying or clearing the grid.
+ */
+struct FMazeSearchScratch
+{
+	/** Tiles whose stamp equals Generation have been visited in the current search. */
+	TArray<uint32> Stamps;
+
+	uint32 Generation;
+
+	/** Tiles whose discovered stamp equals Generation have a valid Cost and Parent. */
+	TArray<uint32> DiscoveredStamps;
+
+	TArray<int32> Cost;
+
+	TArray<int32> Parent;
+
+	/** General purpose tile stack, kept between searches to avoid reallocating. */
+	TArray<FIntPair> Stack;
+
+	/** FIFO of tile indices for breadth-first searches, consumed from a moving head. */
+	TArray<int32> Queue;
+
+	/** Binary heap of open nodes for best-first searches. */
+	TArray<FMazeOpenNode> Open;
+
+	/** Choices for randomized searches. A scratch serves one thread at a time, so it can own the stream. */
+	FMazeRandomStream Random;
+
+	FMazeSearchScratch()
+	{
+		Generation = 0;
+	}
+
+	/**
+	 * Starts a new search over NumTiles tiles (or graph nodes), forgetting all visited marks.
+	 * Buffers only grow, so searches over different sized spaces can share one scratch.
+	 */
+	void Begin(int32 NumTiles)
+	{
+		if (Stamps.Num() < NumTiles) {
+			Stamps.Init(0, NumTiles);
+			DiscoveredStamps.Init(0, NumTiles);
+			Cost.SetNumUninitialized(NumTiles);
+			Parent.SetNumUninitialized(NumTiles);
+			Generation = 0;
+		}
+
+		Generation++;
+		if (Generation == 0) {
+			// Stamps wrapped around; old stamps could now alias the new generation.
+			Stamps.Init(0, NumTiles);
+			DiscoveredStamps.Init(0, NumTiles);
+			Generation = 1;
+		}
+		Stack.Reset();
+		Queue.Reset();
+		Open.Reset();
+	}
+
+	FORCEINLINE bool IsVisited(int32 TileIndex) const
+	{
+		return Stamps[TileIndex] == Generation;
+	}
+
+	FORCEINLINE void Visit(int32 TileIndex)
+	{
+		Stamps[TileIndex] = Generation;
+	}
+
+	FORCEINLINE bool IsDiscovered(int32 TileIndex) const
+	{
+		return DiscoveredStamps[TileIndex] == Generation;
+	}
+
+	FORCEINLINE void Discover(int32 TileIndex, int32 TileCost, int32 ParentIndex)
+	{
+		DiscoveredStamps[TileIndex] = Generation;
+		Cost[TileIndex] = TileCost;
+		Parent[TileIndex] = ParentIndex;
+	}
+
+	FORCEINLINE bool IsOpen(const FMazeTileGrid& Grid, int32 TileRow, int32 TileColumn) const
+	{
+		return Grid.IsPath(TileRow, TileColumn) && !IsVisited(Grid.Index(TileRow, TileColumn));
+	}
+
+	/** Collects the unvisited path neighbors of Tile in up, down, left, right order. */
+	void GetOpenNeighbors(const FMazeTileGrid& Grid, FIntPair Tile, FMazeNeighborArray& Result) const
+	{
+		Result.Reset();
+
+		// Upper Neighbor
+		if (IsOpen(Grid, Tile.y - 1, Tile.x)) {
+			Result.Add(FIntPair(Tile.x, Tile.y - 1));
+		}
+
+		// Lower Neighbor
+		if (IsOpen(Grid, Tile.y + 1, Tile.x)) {
+			Result.Add(FIntPair(Tile.x, Tile.y + 1));
+		}
+
+		// Left Neighbor
+		if (IsOpen(Grid, Tile.y, Tile.x - 1)) {
+			Result.Add(FIntPair(Tile.x - 1, Tile.y));
+		}
+
+		// Right Neighbor
+		if (IsOpen(Grid, Tile.y, Tile.x + 1)) {
+			Result.Add(FIntPair(Tile.x + 1, Tile.y));
+		}
+	}
+
+	/**
+	 * Restricts the first move from StartPoint to StartDirection by marking the other three
+	 * neighbors visited. Returns false, marking nothing, if there is no path tile that way.
+	 */
+	bool BlockAllButHeading(const FMazeTileGrid& Grid, FIntPair StartPoint, EDirection StartDirection)
+	{
+		if (StartDirection == EDirection::D_None) {
+			return false;
+		}
+
+		const FIntPair Heading = FMazeTileGrid::Step(StartPoint, StartDirection);
+		if (!Grid.IsPath(Heading.y, Heading.x)) {
+			return false;
+		}
+
+		for (uint8 Direction = 0; Direction < 4; Direction++) {
+			const FIntPair Neighbor = FMazeTileGrid::Step(StartPoint, (EDirection)Direction);
+			if ((EDirection)Direction != StartDirection && Grid.IsValid(Neighbor.y, Neighbor.x)) {
+				Visit(Grid.Index(Neighbor.y, Neighbor.x));
+			}
+		}
+		return true;
+	}
+};
@@ -2,6 +2,17 @@
 
 #include "ProtoGauntlet.h"
 #include "MazeSegment.h"
+#include "MazeEllerGenerator.h"
+#include "ParallelFor.h"
+
+namespace
+{
+	/** Requests handled per ParallelFor task; small enough to balance uneven path lengths. */
+	const int32 BatchChunkSize = 8;
+
+	/** Stream sequence for randomized path searches, kept apart from layout generation. */
+	const uint64 RandomSearchSequence = 1;
+}
 
 
 // Sets default values
@@ -12,11 +23,37 @@ AMazeSegment::AMazeSegment()
 
 	IsCenterPiece = false;
 	NavMeshReady = false;
+	PathfindingMode = EPathfindingMode::PM_RandomDepthFirst;
+	NextPathQueryId = 0;
+	PathCacheCapacity = 256;
+	RandomSeed = 0;
+	GenerationAlgorithm = EMazeGenerationAlgorithm::MGA_RecursiveBacktracker;
+	bLayoutBuilt = false;
+	bOpenLayoutHint = false;
+	OpenLayoutThreshold = 0.25f;
+	bOpenLayout = false;
+	LayoutVersion = 0;
 	TileSize = 400.f;
 	MazeLengthInTiles = 41;
 	FloorHeight = 100.f;
 	InnerWallHeight = 600.f;
 	OuterWallHeight = 800.f;
+	bUseInstancedWalls = false;
+	WallMesh = nullptr;
+	bMergeStaticWalls = false;
+	bNativeWallAnimation = false;
+	SkippedBorderSides = 0;
+	DoubledBorderSides = 0;
+	bStreamWalls = false;
+	bWallsMaterialized = false;
+
+	SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+	RootComponent = SceneRoot;
+
+	WallInstances = CreateDefaultSubobject<UMazeWallInstances>(TEXT("WallInstances"));
+	WallInstances->AttachParent = SceneRoot;
+
+	WallAnimator = CreateDefaultSubobject<UMazeWallAnimator>(TEXT("WallAnimator"));
 
 }
 
@@ -50,9 +87,20 @@ void AMazeSegment::BeginPlay()
 	Super::BeginPlay();
 	SpawnFloor();
 	SpawnBorders();
-	CreateMazeLayout();
+	if (!bLayoutBuilt) {
+		if (RandomSeed == 0) {
+			RandomSeed = FMazeRandomStream::DeriveSeed(FMath::Rand(), FMath::Rand());
+		}
+		BuildLayout();
+	}
 
-	if (!IsCenterPiece) {
+	WallPool = AMazeWallPool::Find(GetWorld());
+	if (UsesInstancedWalls()) {
+		WallInstances->SetStaticMesh(WallMesh);
+	}
+	ResetWallState();
+	bWallsMaterialized = !bStreamWalls;
+	if (bWallsMaterialized && !IsCenterPiece) {
 		SpawnWalls();
 	}
 
@@ -62,6 +110,109 @@ void AMazeSegment::BeginPlay()
 
 }
 
+void AMazeSegment::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	ReleaseWalls();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AMazeSegment::RebuildLayout(int32 Seed) {
+	ReleaseWalls();
+	RandomSeed = Seed != 0 ? Seed : FMazeRandomStream::DeriveSeed(FMath::Rand(), FMath::Rand());
+	BuildLayout();
+
+	ResetWallState();
+	StreamedWallTiles.Empty();
+	StreamedLoweredTiles.Empty();
+	if (bWallsMaterialized && !IsCenterPiece) {
+		SpawnWalls();
+	}
+}
+
+void AMazeSegment::SetWallStreaming(bool bStreamWalls) {
+	this->bStreamWalls = bStreamWalls && SupportsWallStreaming();
+}
+
+bool AMazeSegment::SupportsWallStreaming() const {
+	return true;
+}
+
+void AMazeSegment::MaterializeWalls() {
+	if (bWallsMaterialized) {
+		return;
+	}
+
+	bWallsMaterialized = true;
+	ResetWallState();
+	if (!IsCenterPiece) {
+		SpawnWalls();
+	}
+	StreamedWallTiles.Empty();
+	StreamedLoweredTiles.Empty();
+}
+
+void AMazeSegment::DematerializeWalls() {
+	if (!bWallsMaterialized || !SupportsWallStreaming()) {
+		return;
+	}
+
+	StreamedWallTiles.Init(false, Grid.Num());
+	StreamedLoweredTiles.Init(false, Grid.Num());
+	for (int32 y = 0; y < Grid.Height; y++) {
+		for (int32 x = 0; x < Grid.Width; x++) {
+			const int32 TileIndex = Grid.Index(y, x);
+			StreamedWallTiles[TileIndex] = HasWallAt(y, x);
+			StreamedLoweredTiles[TileIndex] = IsWallLoweredAt(y, x);
+		}
+	}
+
+	ReleaseWalls();
+	bWallsMaterialized = false;
+}
+
+bool AMazeSegment::AreWallsMaterialized() {
+	return bWallsMaterialized;
+}
+
+int32 AMazeSegment::GetStreamedTile(int32 TileRow, int32 TileColumn) const {
+	if (bWallsMaterialized || StreamedWallTiles.Num() == 0 || !Grid.IsValid(TileRow, TileColumn)) {
+		return INDEX_NONE;
+	}
+	return Grid.Index(TileRow, TileColumn);
+}
+
+void AMazeSegment::ReleaseWalls() {
+	// Cancel native moves and timers first so nothing touches a wall once it is back in the pool.
+	ResetWallState();
+
+	AMazeWallPool* Pool = WallPool.Get();
+	TSet<AMazeWall*> Released;
+	for (AMazeWall* Wall : SpanningWalls) {
+		if (Wall && (!Pool || !Pool->ReleaseWall(Wall))) {
+			Wall->Destroy();
+		}
+	}
+	SpanningWalls.Reset();
+
+	for (int32 TileIndex = 0; TileIndex < Grid.Walls.Num(); TileIndex++) {
+		AMazeWall* Wall = Grid.Walls[TileIndex];
+		Grid.Walls[TileIndex] = nullptr;
+		// A merged piece covers several tiles but goes back only once.
+		if (!Wall || Released.Contains(Wall)) {
+			continue;
+		}
+		Released.Add(Wall);
+		if (!Pool || !Pool->ReleaseWall(Wall)) {
+			Wall->Destroy();
+		}
+	}
+}
+
+void AMazeSegment::ResetWallState() {
+	WallInstances->ResetWalls();
+	WallAnimator->Reset(Grid.Num(), WallInstances);
+}
+
 // Called every frame
 void AMazeSegment::Tick( float DeltaTime )
 {
@@ -79,100 +230,126 @@ void AMazeSegment::ChangeMazeParameters(int32 MazeLengthInTiles, float TileSize,
 	this->OuterWallHeight = OuterWallHeight;
 }
 
-void AMazeSegment::CreateMazeLayout() {
-	if (!IsCenterPiece) {
-		FMazeRowData CellRow;
-		FMazeRowData WallRow;
+void AMazeSegment::SetSharedBorders(uint8 SkipSides, uint8 DoubleSides) {
+	SkippedBorderSides = SkipSides;
+	DoubledBorderSides = DoubleSides & ~SkipSides;
+}
 
-		WallRow.Column.Init(ETileDesignation::TD_Wall, MazeLengthInTiles);
-		for (int32 index = 0; index < MazeLengthInTiles; index++) {
-			if (index % 2 == 1) {
-				CellRow.Column.Add(ETileDesignation::TD_Wall);
-			}
-			else {
-				CellRow.Column.Add(ETileDesignation::TD_Cell);
-			}
+void AMazeSegment::RebuildLayoutCaches() {
+	RebuildLayoutCachesFrom(Grid);
+}
 
-		}
+void AMazeSegment::RebuildLayoutCachesFrom(const FMazeTileGrid& Source) {
+	LayoutVersion++;
+	PathCache.SetCapacity(PathCacheCapacity);
+	PathMasks.Build(Source);
+	TreeIndex.Build(Source);
+	JunctionGraph.Build(Source);
+	bOpenLayout = bOpenLayoutHint || FMazePathfinder::MeasureOpenness(Source) >= OpenLayoutThreshold;
+	FlowFields.Reset();
+	LayoutSnapshot.Reset();
+}
 
-		for (int32 index = 0; index < MazeLengthInTiles; index++) {
-			if (index % 2 == 1) {
-				Row.Add(WallRow);
-			}
-			else {
-				Row.Add(CellRow);
-			}
-		}
+void AMazeSegment::BuildLayout() {
+	BuildLayoutInto(Grid);
+	bLayoutBuilt = true;
+}
+
+void AMazeSegment::BuildLayoutInto(FMazeTileGrid& Target) {
+	RandomStream.Initialize((uint32)RandomSeed);
+	SearchScratch.Random.Initialize((uint32)RandomSeed, RandomSearchSequence);
+	CreateMazeLayout(Target);
+	RebuildLayoutCachesFrom(Target);
+}
 
-		TArray<FIntPair> TileStack;
-		TArray<FIntPair> ValidNeighbors;
-		FIntPair StackHead;
+void AMazeSegment::AdoptLayout(FMazeTileGrid& BuiltGrid) {
+	Grid = MoveTemp(BuiltGrid);
+	bLayoutBuilt = true;
+}
 
-		TileStack.Push(StackHead);
-		Row[0].Column[0] = ETileDesignation::TD_Path;
+void AMazeSegment::GenerateLayout(FMazeTileGrid& Target, FMazeRandomStream& Random) const {
+	if (GenerationAlgorithm == EMazeGenerationAlgorithm::MGA_Eller) {
+		FMazeEllerGenerator::Generate(Target.Width, Target.Height, Random, [&Target](int32 TileRow, const TArray<ETileDesignation>& Tiles) {
+			Target.SetRow(TileRow, Tiles);
+		});
+	} else {
+		GenerateRecursiveBacktracker(Target, Random);
+	}
+}
 
-		while (TileStack.Num()) {
-			ValidNeighbors.SetNum(0);
+void AMazeSegment::GenerateRecursiveBacktracker(FMazeTileGrid& Target, FMazeRandomStream& Random) {
+	Target.ResetCells();
 
-			// Upper Neighbor
-			if (StackHead.y - 2 >= 0 && Row[StackHead.y - 2].Column[StackHead.x] == ETileDesignation::TD_Cell) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y - 2));
-			}
+	TArray<FIntPair> TileStack;
+	TArray<FIntPair> ValidNeighbors;
+	FIntPair StackHead;
 
-			// Lower Neighbor
-			if (StackHead.y + 2 < MazeLengthInTiles && Row[StackHead.y + 2].Column[StackHead.x] == ETileDesignation::TD_Cell) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y + 2));
-			}
+	TileStack.Push(StackHead);
+	Target.Set(0, 0, ETileDesignation::TD_Path);
 
-			// Left Neighbor
-			if (StackHead.x - 2 >= 0 && Row[StackHead.y].Column[StackHead.x - 2] == ETileDesignation::TD_Cell) {
-				ValidNeighbors.Add(FIntPair(StackHead.x - 2, StackHead.y));
-			}
+	while (TileStack.Num()) {
+		ValidNeighbors.SetNum(0);
 
-			// Right Neighbor
-			if (StackHead.x + 2 < MazeLengthInTiles && Row[StackHead.y].Column[StackHead.x + 2] == ETileDesignation::TD_Cell) {
-				ValidNeighbors.Add(FIntPair(StackHead.x + 2, StackHead.y));
-			}
+		// Upper Neighbor
+		if (StackHead.y - 2 >= 0 && Target.Get(StackHead.y - 2, StackHead.x) == ETileDesignation::TD_Cell) {
+			ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y - 2));
+		}
 
-			if (ValidNeighbors.Num() != 0) {
-				// Choose random valid neighbor
-				StackHead = ValidNeighbors[FMath::RandRange(0, ValidNeighbors.Num() - 1)];
+		// Lower Neighbor
+		if (StackHead.y + 2 < Target.Height && Target.Get(StackHead.y + 2, StackHead.x) == ETileDesignation::TD_Cell) {
+			ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y + 2));
+		}
 
-				if (StackHead.y + 2 == TileStack.Last().y) {
-					Row[StackHead.y + 1].Column[StackHead.x] = ETileDesignation::TD_Path;
+		// Left Neighbor
+		if (StackHead.x - 2 >= 0 && Target.Get(StackHead.y, StackHead.x - 2) == ETileDesignation::TD_Cell) {
+			ValidNeighbors.Add(FIntPair(StackHead.x - 2, StackHead.y));
+		}
 
-				}
-				else if (StackHead.y - 2 == TileStack.Last().y) {
-					Row[StackHead.y - 1].Column[StackHead.x] = ETileDesignation::TD_Path;
+		// Right Neighbor
+		if (StackHead.x + 2 < Target.Width && Target.Get(StackHead.y, StackHead.x + 2) == ETileDesignation::TD_Cell) {
+			ValidNeighbors.Add(FIntPair(StackHead.x + 2, StackHead.y));
+		}
 
-				}
-				else if (StackHead.x + 2 == TileStack.Last().x) {
-					Row[StackHead.y].Column[StackHead.x + 1] = ETileDesignation::TD_Path;
+		if (ValidNeighbors.Num() != 0) {
+			// Choose random valid neighbor
+			StackHead = ValidNeighbors[Random.RandRange(0, ValidNeighbors.Num() - 1)];
 
-				}
-				else {
-					Row[StackHead.y].Column[StackHead.x - 1] = ETileDesignation::TD_Path;
+			if (StackHead.y + 2 == TileStack.Last().y) {
+				Target.Set(StackHead.y + 1, StackHead.x, ETileDesignation::TD_Path);
 
-				}
+			}
+			else if (StackHead.y - 2 == TileStack.Last().y) {
+				Target.Set(StackHead.y - 1, StackHead.x, ETileDesignation::TD_Path);
+
+			}
+			else if (StackHead.x + 2 == TileStack.Last().x) {
+				Target.Set(StackHead.y, StackHead.x + 1, ETileDesignation::TD_Path);
 
-				Row[StackHead.y].Column[StackHead.x] = ETileDesignation::TD_Path;
-				TileStack.Push(StackHead);
 			}
 			else {
-				TileStack.Pop();
-				if (TileStack.Num() != 0) {
-					StackHead = TileStack.Last();
-				}
+				Target.Set(StackHead.y, StackHead.x - 1, ETileDesignation::TD_Path);
+
 			}
 
+			Target.Set(StackHead.y, StackHead.x, ETileDesignation::TD_Path);
+			TileStack.Push(StackHead);
 		}
-	} else {
-		FMazeRowData PathRow;
-		PathRow.Column.Init(ETileDesignation::TD_Path, MazeLengthInTiles);
-		for (int32 index = 0; index < MazeLengthInTiles; index++) {
-			Row.Add(PathRow);
-
+		else {
+			TileStack.Pop();
+			if (TileStack.Num() != 0) {
+				StackHead = TileStack.Last();
+			}
 		}
+
+	}
+}
+
+void AMazeSegment::CreateMazeLayout(FMazeTileGrid& Target) {
+	if (!IsCenterPiece) {
+		Target.Init(MazeLengthInTiles, MazeLengthInTiles, ETileDesignation::TD_Wall);
+		GenerateLayout(Target, RandomStream);
+	} else {
+		Target.Init(MazeLengthInTiles, MazeLengthInTiles, ETileDesignation::TD_Path);
 	}
 
 }
@@ -216,208 +393,247 @@ void AMazeSegment::VectorArraytoIntPairArray(TArray<FVector> InputArray, TArray<
 }
 
 ETileDesignation AMazeSegment::GetTileDesignationAt(int32 TileRow, int32 TileColumn) {
-	if (TileRow >= 0 && TileRow < MazeLengthInTiles && TileColumn >= 0 && TileColumn < MazeLengthInTiles) {
-		return Row[TileRow].Column[TileColumn];
+	if (Grid.IsValid(TileRow, TileColumn)) {
+		return Grid.Get(TileRow, TileColumn);
 	}
 
 	return ETileDesignation::TD_OutOfBounds;
 }
 
-void AMazeSegment::FindPathBetweenPoints(FIntPair StartPoint, FIntPair EndPoint, TArray<FIntPair> & Path, EDirection StartDirection) {
-	if (IsValidTileLocation(StartPoint.y, StartPoint.x) ){//&& Row[StartPoint.y].Column[StartPoint.x] != ETileDesignation::TD_Wall && Row[EndPoint.y].Column[EndPoint.x] != ETileDesignation::TD_Wall) {
-		TArray<FMazeRowData> CopyRow;
-		/*for (auto& ColumnData : Row) {
-			CopyRow.Emplace(ColumnData);
-
-		}*/
-		CopyRow.Append(Row);
-		CopyRow[StartPoint.y].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-		Path.Add(StartPoint);
-
-		if (StartDirection != EDirection::D_None) {
-			if (StartDirection == EDirection::D_North && StartPoint.y > 0 && CopyRow[StartPoint.y - 1].Column[StartPoint.x] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-					CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
+bool AMazeSegment::FindPathUsing(FMazeSearchScratch& Scratch, EPathfindingMode Mode, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) const {
+	return FMazeLayoutSnapshot::FindPathInLayout(Grid, TreeIndex, JunctionGraph, bOpenLayout, Scratch, Mode, StartPoint, EndPoint, StartDirection, Path);
+}
 
-			} else if (StartDirection == EDirection::D_East && StartPoint.x < MazeLengthInTiles && CopyRow[StartPoint.y].Column[StartPoint.x + 1] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-					CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-					CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
+TSharedRef<FMazePathQuery, ESPMode::ThreadSafe> AMazeSegment::StartPathQuery(FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TFunction<void()> OnGameThread) {
+	if (!LayoutSnapshot.IsValid()) {
+		LayoutSnapshot = MakeShareable(new FMazeLayoutSnapshot(Grid, TreeIndex, JunctionGraph, bOpenLayout));
+	}
 
-			} else if (StartDirection == EDirection::D_South && StartPoint.y < MazeLengthInTiles && CopyRow[StartPoint.y + 1].Column[StartPoint.x] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-					CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
+	// Worker scratches are fresh per query, so random depth first would replay one path from the same seed.
+	const EPathfindingMode Mode = FMazePathfinder::IsDeterministic(PathfindingMode) ? PathfindingMode : EPathfindingMode::PM_AStar;
+	TSharedRef<FMazePathQuery, ESPMode::ThreadSafe> Query = MakeShareable(new FMazePathQuery(LayoutSnapshot, FMazePathRequest(StartPoint, EndPoint, StartDirection), Mode));
+	FMazePathQuery::Launch(Query, OnGameThread);
+	return Query;
+}
 
-			} else if (StartDirection == EDirection::D_West && StartPoint.x > 0 && CopyRow[StartPoint.y].Column[StartPoint.x - 1] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-					CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-					CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
+int32 AMazeSegment::FindPathBetweenPointsAsync(FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, FMazePathQueryDelegate OnComplete) {
+	const int32 QueryId = NextPathQueryId++;
+	TWeakObjectPtr<AMazeSegment> WeakThis(this);
 
-			} else {
-				Path.Pop();
-			}
+	FMazePendingPathQuery& Pending = PendingPathQueries.Add(QueryId);
+	Pending.OnComplete = OnComplete;
+	Pending.Query = StartPathQuery(StartPoint, EndPoint, StartDirection, [WeakThis, QueryId]() {
+		if (WeakThis.IsValid()) {
+			WeakThis->CompletePathQuery(QueryId);
 		}
-		
-		TArray<FIntPair> ValidNeighbors;
-		FIntPair StackHead = StartPoint;
-		while (Path.Num() != 0 && Path.Last() != EndPoint) {
-			ValidNeighbors.SetNum(0);
+	});
+	return QueryId;
+}
 
-			// Upper Neighbor
-			if (StackHead.y - 1 >= 0 && CopyRow[StackHead.y - 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y - 1));
-			}
+void AMazeSegment::CancelPathQuery(int32 QueryId) {
+	FMazePendingPathQuery Pending;
+	if (PendingPathQueries.RemoveAndCopyValue(QueryId, Pending)) {
+		Pending.Query->bCancelled = true;
+	}
+}
 
-			// Lower Neighbor
-			if (StackHead.y + 1 < MazeLengthInTiles && CopyRow[StackHead.y + 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y + 1));
-			}
+void AMazeSegment::CompletePathQuery(int32 QueryId) {
+	FMazePendingPathQuery Pending;
+	if (!PendingPathQueries.RemoveAndCopyValue(QueryId, Pending) || Pending.Query->bCancelled) {
+		return;
+	}
 
-			// Left Neighbor
-			if (StackHead.x - 1 >= 0 && CopyRow[StackHead.y].Column[StackHead.x - 1] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x - 1, StackHead.y));
-			}
+	TArray<FVector> Path;
+	IntPairArraytoVectorArray(Pending.Query->Path, Path);
+	Pending.OnComplete.ExecuteIfBound(QueryId, Pending.Query->bFound, Path);
+}
 
-			// Right Neighbor
-			if (StackHead.x + 1 < MazeLengthInTiles && CopyRow[StackHead.y].Column[StackHead.x + 1] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x + 1, StackHead.y));
-			}
+void AMazeSegment::FindPathBetweenPointsLatent(int32 StartPointX, int32 StartPointY, int32 EndPointX, int32 EndPointY, EDirection StartDirection, TArray<FVector> & Path, bool & bFound, FLatentActionInfo LatentInfo) {
+	FLatentActionManager& LatentActionManager = GetWorld()->GetLatentActionManager();
+	if (LatentActionManager.FindExistingAction<FMazePathLatentAction>(LatentInfo.CallbackTarget, LatentInfo.UUID) == nullptr) {
+		TSharedRef<FMazePathQuery, ESPMode::ThreadSafe> Query = StartPathQuery(FIntPair(StartPointX, StartPointY), FIntPair(EndPointX, EndPointY), StartDirection, TFunction<void()>());
+		LatentActionManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID, new FMazePathLatentAction(this, Query, Path, bFound, LatentInfo));
+	}
+}
 
-			if (ValidNeighbors.Num() != 0) {
-				// Choose random valid neighbor
-				StackHead = ValidNeighbors[FMath::RandRange(0, ValidNeighbors.Num() - 1)];
-				CopyRow[StackHead.y].Column[StackHead.x] = ETileDesignation::TD_Visited;
-				Path.Push(StackHead);
-			} else {
-				Path.Pop();
-				if (Path.Num() != 0) {
-					StackHead = Path.Last();
-				}
-			}
-		}
+void AMazeSegment::FindPathBetweenPoints(FIntPair StartPoint, FIntPair EndPoint, TArray<FIntPair> & Path, EDirection StartDirection) {
+	if (!FMazePathfinder::IsDeterministic(PathfindingMode)) {
+		FindPathUsing(SearchScratch, PathfindingMode, StartPoint, EndPoint, StartDirection, Path);
+		return;
+	}
+
+	const FMazePathCacheKey Key(StartPoint, EndPoint, StartDirection, PathfindingMode, LayoutVersion);
+	if (const TArray<FIntPair>* CachedPath = PathCache.Find(Key)) {
+		Path.Append(*CachedPath);
+		return;
 	}
+
+	// Failed searches are cached as empty paths.
+	const int32 PreviousNum = Path.Num();
+	FindPathUsing(SearchScratch, PathfindingMode, StartPoint, EndPoint, StartDirection, Path);
+	TArray<FIntPair> FoundPath;
+	FoundPath.Append(Path.GetData() + PreviousNum, Path.Num() - PreviousNum);
+	PathCache.Add(Key, FoundPath);
 };
 
+void AMazeSegment::GetPathCacheStats(int32 & Hits, int32 & Misses) {
+	Hits = PathCache.GetHits();
+	Misses = PathCache.GetMisses();
+}
+
+int32 AMazeSegment::GetLayoutVersion() {
+	return (int32)LayoutVersion;
+}
+
+bool AMazeSegment::IsOpenLayout() {
+	return bOpenLayout;
+}
+
+void AMazeSegment::SetRandomSeed(int32 Seed) {
+	RandomSeed = Seed;
+}
+
+int32 AMazeSegment::GetRandomSeed() {
+	return RandomSeed;
+}
+
 void AMazeSegment::FindPathBetweenPointsBP(int32 StartPointX, int32 StartPointY, int32 EndPointX, int32 EndPointY, TArray<FVector> & Path, EDirection StartDirection) {
 	TArray<FIntPair> FIntPairPath;
 	FindPathBetweenPoints(FIntPair(StartPointX, StartPointY), FIntPair(EndPointX, EndPointY), FIntPairPath, StartDirection);
 	IntPairArraytoVectorArray(FIntPairPath, Path);
 }
 
+int32 AMazeSegment::GetPathLength(FIntPair StartPoint, FIntPair EndPoint) {
+	if (TreeIndex.IsValid() && TreeIndex.Contains(StartPoint) && TreeIndex.Contains(EndPoint)) {
+		return TreeIndex.GetPathLength(StartPoint, EndPoint);
+	}
+
+	TArray<FIntPair> Path;
+	if (IsValidTileLocation(StartPoint.y, StartPoint.x) &&
+		FMazePathfinder::FindPathAStar(Grid, SearchScratch, StartPoint, EndPoint, EDirection::D_None, Path)) {
+		return Path.Num() - 1;
+	}
+	return -1;
+}
+
+const FMazeFlowField* AMazeSegment::GetFlowField(AActor* Target, bool bFlee) {
+	if (!Target) {
+		return nullptr;
+	}
+
+	FIntPair TargetTile;
+	GetTileIndexAtLocation(Target->GetActorLocation(), TargetTile.y, TargetTile.x);
+
+	FMazeTargetFlowField* Entry = nullptr;
+	for (int32 i = FlowFields.Num() - 1; i >= 0; i--) {
+		if (!FlowFields[i].Target.IsValid()) {
+			FlowFields.RemoveAtSwap(i);
+		}
+	}
+	for (FMazeTargetFlowField& Candidate : FlowFields) {
+		if (Candidate.Target.Get() == Target && Candidate.Field.IsFlee() == bFlee) {
+			Entry = &Candidate;
+			break;
+		}
+	}
+
+	if (!Entry) {
+		Entry = &FlowFields[FlowFields.AddDefaulted()];
+		Entry->Target = Target;
+	}
+
+	if (!Entry->Field.IsBuilt() || Entry->Field.GetTargetTile() != TargetTile) {
+		Entry->Field.Build(Grid, TargetTile, bFlee);
+	}
+	return &Entry->Field;
+}
+
+EDirection AMazeSegment::GetFlowDirection(AActor* Target, FIntPair FromTile, bool bFlee) {
+	const FMazeFlowField* Field = GetFlowField(Target, bFlee);
+	return Field ? Field->GetNextDirection(FromTile) : EDirection::D_None;
+}
+
+EDirection AMazeSegment::GetFlowDirectionAtLocation(AActor* Target, FVector Location, bool bFlee) {
+	FIntPair FromTile;
+	GetTileIndexAtLocation(Location, FromTile.y, FromTile.x);
+	return GetFlowDirection(Target, FromTile, bFlee);
+}
+
+int32 AMazeSegment::GetFlowDistance(AActor* Target, FIntPair FromTile) {
+	const FMazeFlowField* Field = GetFlowField(Target, false);
+	return Field ? Field->GetDistance(FromTile) : -1;
+}
+
+void AMazeSegment::FindPathsBatch(const TArray<FMazePathRequest> & Requests, FMazePathBatchResult & Result) {
+	const int32 NumRequests = Requests.Num();
+	const int32 NumChunks = (NumRequests + BatchChunkSize - 1) / BatchChunkSize;
+	const EPathfindingMode Mode = FMazePathfinder::IsDeterministic(PathfindingMode) ? PathfindingMode : EPathfindingMode::PM_AStar;
+
+	if (BatchScratch.Num() < NumChunks) {
+		BatchScratch.SetNum(NumChunks);
+		BatchTiles.SetNum(NumChunks);
+	}
+	BatchPathLengths.SetNumUninitialized(NumRequests);
+
+	// Each chunk owns its scratch and output; the layout caches are only read.
+	ParallelFor(NumChunks, [&](int32 Chunk) {
+		FMazeSearchScratch& Scratch = BatchScratch[Chunk];
+		TArray<FIntPair>& Tiles = BatchTiles[Chunk];
+		Tiles.Reset();
+
+		const int32 LastRequest = FMath::Min(NumRequests, (Chunk + 1) * BatchChunkSize);
+		for (int32 i = Chunk * BatchChunkSize; i < LastRequest; i++) {
+			const int32 PreviousNum = Tiles.Num();
+			FindPathUsing(Scratch, Mode, Requests[i].StartPoint, Requests[i].EndPoint, Requests[i].StartDirection, Tiles);
+			BatchPathLengths[i] = Tiles.Num() - PreviousNum;
+		}
+	});
+
+	Result.Offsets.SetNumUninitialized(NumRequests + 1);
+	int32 TotalTiles = 0;
+	for (int32 i = 0; i < NumRequests; i++) {
+		Result.Offsets[i] = TotalTiles;
+		TotalTiles += BatchPathLengths[i];
+	}
+	Result.Offsets[NumRequests] = TotalTiles;
+
+	Result.Tiles.Reset(TotalTiles);
+	for (int32 Chunk = 0; Chunk < NumChunks; Chunk++) {
+		Result.Tiles.Append(BatchTiles[Chunk]);
+	}
+}
+
+void AMazeSegment::GetBatchPathBP(const FMazePathBatchResult & Result, int32 RequestIndex, TArray<FVector> & Path) {
+	if (RequestIndex >= 0 && RequestIndex < Result.NumPaths()) {
+		TArray<FIntPair> FIntPairPath;
+		FIntPairPath.Append(Result.Tiles.GetData() + Result.Offsets[RequestIndex], Result.Offsets[RequestIndex + 1] - Result.Offsets[RequestIndex]);
+		IntPairArraytoVectorArray(FIntPairPath, Path);
+	}
+}
+
 void AMazeSegment::GetAllTilesInSection(FIntPair StartPoint, TArray<FIntPair> & Result, EDirection StartDirection) {
 	if (IsValidTileLocation(StartPoint.y, StartPoint.x) &&
-		Row[StartPoint.y].Column[StartPoint.x] != ETileDesignation::TD_Wall) {
-		TArray<FMazeRowData> CopyRow;
-		/*for (auto& ColumnData : Row) {
-		CopyRow.Emplace(ColumnData);
-
-		}*/
-		CopyRow.Append(Row);
-		CopyRow[StartPoint.y].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-		TArray<FIntPair> PathStack;
+		Grid.Get(StartPoint.y, StartPoint.x) != ETileDesignation::TD_Wall) {
+		SearchScratch.Begin(Grid.Num());
+		SearchScratch.Visit(Grid.Index(StartPoint.y, StartPoint.x));
+		TArray<FIntPair>& PathStack = SearchScratch.Stack;
 		PathStack.Add(StartPoint);
 		Result.Add(StartPoint);
 
-		if (StartDirection == EDirection::D_North && StartPoint.y > 0 && CopyRow[StartPoint.y - 1].Column[StartPoint.x] == ETileDesignation::TD_Path) {
-			if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-				CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-				CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-				CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-			}
-		} else if (StartDirection == EDirection::D_East && StartPoint.x < MazeLengthInTiles && CopyRow[StartPoint.y].Column[StartPoint.x + 1] == ETileDesignation::TD_Path) {
-			if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-				CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-				CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-				CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-			}
-		} else if (StartDirection == EDirection::D_South && StartPoint.y < MazeLengthInTiles && CopyRow[StartPoint.y + 1].Column[StartPoint.x] == ETileDesignation::TD_Path) {
-			if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-				CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-				CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-				CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-			}
-		} else if (StartDirection == EDirection::D_West && StartPoint.x > 0 && CopyRow[StartPoint.y].Column[StartPoint.x - 1] == ETileDesignation::TD_Path) {
-			if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-				CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-				CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-			}
-			if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-				CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-			}
-		} else {
+		if (!SearchScratch.BlockAllButHeading(Grid, StartPoint, StartDirection)) {
 			Result.Pop();
 			PathStack.Pop();
 		}
 
-		TArray<FIntPair> ValidNeighbors;
+		FMazeNeighborArray ValidNeighbors;
 		FIntPair StackHead = StartPoint;
 		while (PathStack.Num() != 0) {
-			ValidNeighbors.SetNum(0);
-
-			// Upper Neighbor
-			if (StackHead.y - 1 >= 0 && CopyRow[StackHead.y - 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y - 1));
-			}
-
-			// Lower Neighbor
-			if (StackHead.y + 1 < MazeLengthInTiles && CopyRow[StackHead.y + 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y + 1));
-			}
-
-			// Left Neighbor
-			if (StackHead.x - 1 >= 0 && CopyRow[StackHead.y].Column[StackHead.x - 1] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x - 1, StackHead.y));
-			}
-
-			// Right Neighbor
-			if (StackHead.x + 1 < MazeLengthInTiles && CopyRow[StackHead.y].Column[StackHead.x + 1] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x + 1, StackHead.y));
-			}
+			SearchScratch.GetOpenNeighbors(Grid, StackHead, ValidNeighbors);
 
 			if (ValidNeighbors.Num() != 0) {
 				// Choose random valid neighbor
-				StackHead = ValidNeighbors[FMath::RandRange(0, ValidNeighbors.Num() - 1)];
-				CopyRow[StackHead.y].Column[StackHead.x] = ETileDesignation::TD_Visited;
+				StackHead = ValidNeighbors[RandomStream.RandRange(0, ValidNeighbors.Num() - 1)];
+				SearchScratch.Visit(Grid.Index(StackHead.y, StackHead.x));
 				PathStack.Push(StackHead);
 				Result.Push(StackHead);
 			}
@@ -450,45 +666,20 @@ void AMazeSegment::GetDirectionsFromVectorArray(TArray<FVector> PathArray, TArra
 }
 
 void AMazeSegment::CreateRandomPathFromStartPoint(FIntPair StartPoint, TArray<FIntPair> & Result, int32 PathLength) {
-	if (IsValidTileLocation(StartPoint.y, StartPoint.x) && Row[StartPoint.y].Column[StartPoint.x] != ETileDesignation::TD_Wall) {
-		TArray<FMazeRowData> CopyRow;
-		/*for (auto& ColumnData : Row) {
-		CopyRow.Emplace(ColumnData);
-
-		}*/
-		CopyRow.Append(Row);
-		CopyRow[StartPoint.y].Column[StartPoint.x] = ETileDesignation::TD_Visited;
+	if (IsValidTileLocation(StartPoint.y, StartPoint.x) && Grid.Get(StartPoint.y, StartPoint.x) != ETileDesignation::TD_Wall) {
+		SearchScratch.Begin(Grid.Num());
+		SearchScratch.Visit(Grid.Index(StartPoint.y, StartPoint.x));
 		Result.Add(StartPoint);
 
-		TArray<FIntPair> ValidNeighbors;
+		FMazeNeighborArray ValidNeighbors;
 		FIntPair StackHead = StartPoint;
 		while (Result.Num() < PathLength && Result.Num() != 0) {
-			ValidNeighbors.SetNum(0);
-
-			// Upper Neighbor
-			if (StackHead.y - 1 >= 0 && CopyRow[StackHead.y - 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y - 1));
-			}
-
-			// Lower Neighbor
-			if (StackHead.y + 1 < MazeLengthInTiles && CopyRow[StackHead.y + 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y + 1));
-			}
-
-			// Left Neighbor
-			if (StackHead.x - 1 >= 0 && CopyRow[StackHead.y].Column[StackHead.x - 1] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x - 1, StackHead.y));
-			}
-
-			// Right Neighbor
-			if (StackHead.x + 1 < MazeLengthInTiles && CopyRow[StackHead.y].Column[StackHead.x + 1] == ETileDesignation::TD_Path) {
-				ValidNeighbors.Add(FIntPair(StackHead.x + 1, StackHead.y));
-			}
+			SearchScratch.GetOpenNeighbors(Grid, StackHead, ValidNeighbors);
 
 			if (ValidNeighbors.Num() != 0) {
 				// Choose random valid neighbor
-				StackHead = ValidNeighbors[FMath::RandRange(0, ValidNeighbors.Num() - 1)];
-				CopyRow[StackHead.y].Column[StackHead.x] = ETileDesignation::TD_Visited;
+				StackHead = ValidNeighbors[RandomStream.RandRange(0, ValidNeighbors.Num() - 1)];
+				SearchScratch.Visit(Grid.Index(StackHead.y, StackHead.x));
 				Result.Push(StackHead);
 			}
 			else {
@@ -525,167 +716,29 @@ bool AMazeSegment::PathHasIntersectionBP(TArray<FVector> Path, int32 & Intersect
 }
 
 bool AMazeSegment::IsCorner(int32 TileRow, int32 TileColumn) {
-	bool Result = false;
-	if (IsValidTileLocation(TileRow, TileColumn)) {
-		if (IsValidTileLocation(TileRow - 1, TileColumn) &&
-				Row[TileRow - 1].Column[TileColumn] == ETileDesignation::TD_Path ||
-					(IsValidTileLocation(TileRow + 1, TileColumn) &&
-						Row[TileRow + 1].Column[TileColumn] == ETileDesignation::TD_Path)) {
-			if ((IsValidTileLocation(TileRow, TileColumn - 1) &&
-					Row[TileRow].Column[TileColumn - 1] == ETileDesignation::TD_Path) ||
-						(IsValidTileLocation(TileRow, TileColumn + 1) &&
-							Row[TileRow].Column[TileColumn + 1] == ETileDesignation::TD_Path)) {
-				Result = true;
-
-			}
-
-		} 
-
-	}
-	return Result;
-
+	return PathMasks.IsCorner(TileRow, TileColumn);
 }
 
 bool AMazeSegment::IsIntersection(int32 TileRow, int32 TileColumn) {
-	bool Result = false;
-	if (IsValidTileLocation(TileRow, TileColumn)) {
-		int32 ValidNeighbors = 0;
-
-		if (IsValidTileLocation(TileRow - 1, TileColumn) && 
-			Row[TileRow - 1].Column[TileColumn] == ETileDesignation::TD_Path ) {
-			ValidNeighbors++;
-		}
-
-		if (IsValidTileLocation(TileRow + 1, TileColumn) &&
-			Row[TileRow + 1].Column[TileColumn] == ETileDesignation::TD_Path) {
-			ValidNeighbors++;
-		}
-
-		if (IsValidTileLocation(TileRow, TileColumn - 1) &&
-			Row[TileRow].Column[TileColumn - 1] == ETileDesignation::TD_Path) {
-			ValidNeighbors++;
-		}
-
-		if (IsValidTileLocation(TileRow, TileColumn + 1) &&
-			Row[TileRow].Column[TileColumn + 1] == ETileDesignation::TD_Path) {
-			ValidNeighbors++;
-		}
-
-		if (ValidNeighbors >= 3) {
-			Result = true;
-		}
-	}
-	return Result;
-
+	return PathMasks.IsIntersection(TileRow, TileColumn);
 }
 
 bool AMazeSegment::IsValidTileLocation(int32 TileRow, int32 TileColumn) {
-	return TileColumn >= 0 && TileRow >= 0 && TileColumn < MazeLengthInTiles && TileRow < MazeLengthInTiles;
+	return Grid.IsValid(TileRow, TileColumn);
 }
 
 void AMazeSegment::NextIntersection(FIntPair StartPoint, FIntPair & Intersection, EDirection StartDirection, int32 MaxDistance) {
 	if (IsValidTileLocation(StartPoint.y, StartPoint.x) &&
-		Row[StartPoint.y].Column[StartPoint.x] != ETileDesignation::TD_Wall) {
+		Grid.Get(StartPoint.y, StartPoint.x) != ETileDesignation::TD_Wall) {
 		if (!IsIntersection(StartPoint.y, StartPoint.x)) {
-			TArray<FMazeRowData> CopyRow;
-			CopyRow.Append(Row);
-			CopyRow[StartPoint.y].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-			TArray<FIntPair> PathStack;
-			PathStack.Add(StartPoint);
-
-			if (StartDirection == EDirection::D_North && StartPoint.y - 1 > 0 && CopyRow[StartPoint.y - 1].Column[StartPoint.x] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-					CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-			}
-			else if (StartDirection == EDirection::D_East && StartPoint.x + 1 < MazeLengthInTiles && CopyRow[StartPoint.y].Column[StartPoint.x + 1] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-					CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-					CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-			}
-			else if (StartDirection == EDirection::D_South && StartPoint.y + 1< MazeLengthInTiles && CopyRow[StartPoint.y + 1].Column[StartPoint.x] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x - 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x - 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-					CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-			}
-			else if (StartDirection == EDirection::D_West && StartPoint.x - 1 > 0 && CopyRow[StartPoint.y].Column[StartPoint.x - 1] == ETileDesignation::TD_Path) {
-				if (IsValidTileLocation(StartPoint.y, StartPoint.x + 1)) {
-					CopyRow[StartPoint.y].Column[StartPoint.x + 1] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y - 1, StartPoint.x)) {
-					CopyRow[StartPoint.y - 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-				if (IsValidTileLocation(StartPoint.y + 1, StartPoint.x)) {
-					CopyRow[StartPoint.y + 1].Column[StartPoint.x] = ETileDesignation::TD_Visited;
-				}
-			}
-			else {
-				PathStack.Pop();
-
-			}
-
-			TArray<FIntPair> ValidNeighbors;
-			FIntPair StackHead = StartPoint;
-			while (PathStack.Num() != 0 &&
-				(PathStack.Num() - 2 > MaxDistance || !IsIntersection(StackHead.y, StackHead.x))) {
-				ValidNeighbors.SetNum(0);
-
-				// Upper Neighbor
-				if (StackHead.y - 1 >= 0 && CopyRow[StackHead.y - 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-					ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y - 1));
-				}
-
-				// Lower Neighbor
-				if (StackHead.y + 1 < MazeLengthInTiles && CopyRow[StackHead.y + 1].Column[StackHead.x] == ETileDesignation::TD_Path) {
-					ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y + 1));
-				}
-
-				// Left Neighbor
-				if (StackHead.x - 1 >= 0 && CopyRow[StackHead.y].Column[StackHead.x - 1] == ETileDesignation::TD_Path) {
-					ValidNeighbors.Add(FIntPair(StackHead.x - 1, StackHead.y));
-				}
-
-				// Right Neighbor
-				if (StackHead.x + 1 < MazeLengthInTiles && CopyRow[StackHead.y].Column[StackHead.x + 1] == ETileDesignation::TD_Path) {
-					ValidNeighbors.Add(FIntPair(StackHead.x + 1, StackHead.y));
-				}
-
-				if (ValidNeighbors.Num() != 0) {
-					// Choose random valid neighbor
-					StackHead = ValidNeighbors[FMath::RandRange(0, ValidNeighbors.Num() - 1)];
-					CopyRow[StackHead.y].Column[StackHead.x] = ETileDesignation::TD_Visited;
-					PathStack.Push(StackHead);
-				}
-				else {
-					PathStack.Pop();
-					if (PathStack.Num() != 0) {
-						StackHead = PathStack.Last();
-					}
-				}
-			}
-
-			if (PathStack.Num() == 0) {
-				Intersection = FIntPair(-1, -1);
+			// Dead ends and out of range intersections both count as not found.
+			FIntPair Junction;
+			int32 Distance;
+			if (JunctionGraph.GetNextJunction(StartPoint, StartDirection, Junction, Distance) &&
+				Distance <= MaxDistance + 1 && IsIntersection(Junction.y, Junction.x)) {
+				Intersection = Junction;
 			} else {
-				Intersection = PathStack.Last();
+				Intersection = FIntPair(-1, -1);
 			}
 
 		} else {
@@ -718,22 +771,183 @@ void AMazeSegment::GetLocationOfTile(FVector & Location, int32 TileRow, int32 Ti
 }
 
 void AMazeSegment::SpawnWalls() {
-	AMazeWall* CurrentWall;
 	float VisibilityOffset = 0.1f; // Keeps the ground from clipping with lowered walls
+	if (bMergeStaticWalls) {
+		TArray<FMazeWallRect> Rects;
+		TArray<int32> TileToRect;
+		FMazeWallMerge::Build(Grid, Rects, TileToRect);
+		for (const FMazeWallRect& Rect : Rects) {
+			SpawnWallPiece(Rect, FVector((float)(Rect.TileColumn + 1) * TileSize, (float)(Rect.TileRow + 1) * TileSize, FloorHeight - VisibilityOffset));
+		}
+		return;
+	}
+
 	for (int y = 0; y < MazeLengthInTiles; y++) {
-		Row[y].ColumnWallRef.SetNum(MazeLengthInTiles);
 		for (int x = 0; x < MazeLengthInTiles; x++) {
-			if (Row[y].Column[x] == ETileDesignation::TD_Wall) {
-				CurrentWall = Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass));
-				if (CurrentWall) {
-					CurrentWall->SetActorLocation(GetActorLocation() + FVector((float)(x + 1) * TileSize, (float)(y + 1) * TileSize, FloorHeight - VisibilityOffset));
-					CurrentWall->SetActorScale3D(FVector(TileSize / 100.f, TileSize / 100.f, InnerWallHeight / 100.f));
-					Row[y].ColumnWallRef[x] = CurrentWall;
-				}
+			if (Grid.Get(y, x) == ETileDesignation::TD_Wall) {
+				SpawnWallAt(y, x, FVector((float)(x + 1) * TileSize, (float)(y + 1) * TileSize, FloorHeight - VisibilityOffset));
+			}
+		}
+
+	}
+}
+
+bool AMazeSegment::UsesInstancedWalls() const {
+	return bUseInstancedWalls && WallMesh != nullptr;
+}
+
+void AMazeSegment::SpawnWallAt(int32 TileRow, int32 TileColumn, const FVector& RelativeLocation, bool bStartLowered) {
+	SpawnWallPiece(FMazeWallRect(TileRow, TileColumn, 1, 1), RelativeLocation, bStartLowered);
+}
+
+void AMazeSegment::SpawnWallPiece(const FMazeWallRect& Rect, const FVector& RelativeLocation, bool bStartLowered) {
+	// A segment streaming back in puts its walls back the way they were left.
+	if (StreamedLoweredTiles.Num() != 0) {
+		bStartLowered = StreamedLoweredTiles[Grid.Index(Rect.TileRow, Rect.TileColumn)];
+	}
+	const FVector Scale((float)Rect.Columns * TileSize / 100.f, (float)Rect.Rows * TileSize / 100.f, InnerWallHeight / 100.f);
+	const FVector StartLocation = RelativeLocation - FVector(0.f, 0.f, bStartLowered ? InnerWallHeight : 0.f);
+	int32 Slot = INDEX_NONE;
+	AMazeWall* NewWall = nullptr;
+	if (UsesInstancedWalls()) {
+		const int32 Instance = WallInstances->AddWall(StartLocation, Scale);
+		Slot = WallAnimator->AddWall(nullptr, Instance, RelativeLocation.Z, RelativeLocation.Z - InnerWallHeight, bStartLowered);
+	} else {
+		NewWall = AcquireWall();
+		if (!NewWall) {
+			return;
+		}
+		NewWall->SetActorLocation(GetActorLocation() + StartLocation);
+		NewWall->SetActorScale3D(Scale);
+		if (bNativeWallAnimation) {
+			const float RaisedZ = GetActorLocation().Z + RelativeLocation.Z;
+			Slot = WallAnimator->AddWall(NewWall, INDEX_NONE, RaisedZ, RaisedZ - InnerWallHeight, bStartLowered);
+		} else if (bStartLowered) {
+			NewWall->LowerEnabled = false;
+		}
+	}
+
+	for (int32 y = Rect.TileRow; y < Rect.TileRow + Rect.Rows; y++) {
+		for (int32 x = Rect.TileColumn; x < Rect.TileColumn + Rect.Columns; x++) {
+			Grid.SetWall(y, x, NewWall);
+			if (Slot != INDEX_NONE) {
+				WallAnimator->MapTile(Grid.Index(y, x), Slot);
 			}
 		}
+	}
+}
+
+AMazeWall* AMazeSegment::AcquireWall() {
+	AMazeWallPool* Pool = WallPool.Get();
+	return Pool ? Pool->AcquireWall(WallClass) : Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass));
+}
+
+AMazeWall* AMazeSegment::SpawnSpanningWall(const FVector& RelativeLocation, const FVector& Scale) {
+	AMazeWall* NewWall = AcquireWall();
+	if (NewWall) {
+		NewWall->SetActorLocation(GetActorLocation() + RelativeLocation);
+		NewWall->SetActorScale3D(Scale);
+		SpanningWalls.Add(NewWall);
+	}
+	return NewWall;
+}
+
+int32 AMazeSegment::GetAnimatorSlot(int32 TileRow, int32 TileColumn) const {
+	return Grid.IsValid(TileRow, TileColumn) ? WallAnimator->GetSlotForTile(Grid.Index(TileRow, TileColumn)) : INDEX_NONE;
+}
+
+void AMazeSegment::LowerWallAt(int32 TileRow, int32 TileColumn) {
+	const int32 StreamedTile = GetStreamedTile(TileRow, TileColumn);
+	if (StreamedTile != INDEX_NONE) {
+		StreamedLoweredTiles[StreamedTile] = StreamedWallTiles[StreamedTile];
+		return;
+	}
+
+	const int32 Slot = GetAnimatorSlot(TileRow, TileColumn);
+	if (Slot != INDEX_NONE) {
+		WallAnimator->Lower(Slot);
+	} else if (AMazeWall* Wall = GetBlueprintWall(TileRow, TileColumn)) {
+		Wall->Lower();
+	}
+}
+
+void AMazeSegment::RaiseWallAt(int32 TileRow, int32 TileColumn) {
+	const int32 StreamedTile = GetStreamedTile(TileRow, TileColumn);
+	if (StreamedTile != INDEX_NONE) {
+		StreamedLoweredTiles[StreamedTile] = false;
+		return;
+	}
+
+	const int32 Slot = GetAnimatorSlot(TileRow, TileColumn);
+	if (Slot != INDEX_NONE) {
+		WallAnimator->Raise(Slot);
+	} else if (AMazeWall* Wall = GetBlueprintWall(TileRow, TileColumn)) {
+		Wall->Raise();
+	}
+}
+
+void AMazeSegment::RaiseAndLowerWallAt(int32 TileRow, int32 TileColumn, bool Deadly) {
+	const int32 Slot = GetAnimatorSlot(TileRow, TileColumn);
+	if (Slot != INDEX_NONE) {
+		WallAnimator->RaiseAndLower(Slot, Deadly);
+		if (Deadly && !WallAnimator->GetActor(Slot)) {
+			OnDeadlyInstancedWallRise(TileRow, TileColumn, WallAnimator->RaiseDuration);
+		}
+	} else if (AMazeWall* Wall = GetBlueprintWall(TileRow, TileColumn)) {
+		Wall->RaiseAndLower(Deadly);
+	}
+}
+
+void AMazeSegment::LowerAndRaiseWallAt(int32 TileRow, int32 TileColumn) {
+	const int32 Slot = GetAnimatorSlot(TileRow, TileColumn);
+	if (Slot != INDEX_NONE) {
+		WallAnimator->LowerAndRaise(Slot);
+	} else if (AMazeWall* Wall = GetBlueprintWall(TileRow, TileColumn)) {
+		Wall->LowerAndRaise();
+	}
+}
+
+void AMazeSegment::LowerWallOnTimerAt(int32 TileRow, int32 TileColumn, float LoweredTime) {
+	const int32 Slot = GetAnimatorSlot(TileRow, TileColumn);
+	if (Slot != INDEX_NONE) {
+		WallAnimator->LowerFor(Slot, LoweredTime);
+	} else if (AMazeWall* Wall = GetBlueprintWall(TileRow, TileColumn)) {
+		Wall->LowerOnTimer(LoweredTime);
+	}
+}
+
+void AMazeSegment::RaiseWallOnTimerAt(int32 TileRow, int32 TileColumn, float RaisedTime) {
+	const int32 Slot = GetAnimatorSlot(TileRow, TileColumn);
+	if (Slot != INDEX_NONE) {
+		WallAnimator->RaiseFor(Slot, RaisedTime);
+	} else if (AMazeWall* Wall = GetBlueprintWall(TileRow, TileColumn)) {
+		Wall->RaiseOnTimer(RaisedTime);
+	}
+}
+
+bool AMazeSegment::HasWallAt(int32 TileRow, int32 TileColumn) {
+	const int32 StreamedTile = GetStreamedTile(TileRow, TileColumn);
+	if (StreamedTile != INDEX_NONE) {
+		return StreamedWallTiles[StreamedTile];
+	}
+	return GetAnimatorSlot(TileRow, TileColumn) != INDEX_NONE || GetBlueprintWall(TileRow, TileColumn) != nullptr;
+}
 
+bool AMazeSegment::IsWallLoweredAt(int32 TileRow, int32 TileColumn) {
+	const int32 StreamedTile = GetStreamedTile(TileRow, TileColumn);
+	if (StreamedTile != INDEX_NONE) {
+		return StreamedLoweredTiles[StreamedTile];
+	}
+	const int32 Slot = GetAnimatorSlot(TileRow, TileColumn);
+	if (Slot != INDEX_NONE) {
+		return WallAnimator->IsLowered(Slot);
 	}
+	AMazeWall* Wall = GetBlueprintWall(TileRow, TileColumn);
+	return Wall && !Wall->LowerEnabled;
+}
+
+AMazeWall* AMazeSegment::GetBlueprintWall(int32 TileRow, int32 TileColumn) const {
+	return Grid.IsValid(TileRow, TileColumn) ? Grid.GetWall(TileRow, TileColumn) : nullptr;
 }
 
 void AMazeSegment::SpawnFloor() {
@@ -744,45 +958,41 @@ void AMazeSegment::SpawnFloor() {
 }
 
 void AMazeSegment::SpawnBorders() {
-	//Left Border
-	AActor* BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector(0.f, 0.f, FloorHeight));
-	BorderWall->SetActorScale3D(FVector(TileSize / 100.f, (float)((MazeLengthInTiles + 2) / 2) * TileSize / 100.f, OuterWallHeight / 100.f));
+	const int32 HalfLength = (MazeLengthInTiles + 2) / 2;
+	const float EdgeLength = (float)(MazeLengthInTiles / 2);
+	const float FarEdge = (float)(MazeLengthInTiles + 1);
 
-	BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector(0.f, (float)((MazeLengthInTiles + 2) / 2 + 1) * TileSize, FloorHeight));
-	BorderWall->SetActorScale3D(FVector(TileSize / 100.f, (float)((MazeLengthInTiles + 2) / 2) * TileSize / 100.f, OuterWallHeight / 100.f));
+	//Left Border
+	if (!(SkippedBorderSides & (1 << (uint8)EDirection::D_West))) {
+		SpawnBorderPiece(FVector(0.f, 0.f, FloorHeight), 1.f, (float)HalfLength);
+		SpawnBorderPiece(FVector(0.f, (float)(HalfLength + 1) * TileSize, FloorHeight), 1.f, (float)HalfLength);
+	}
 
 	//Right Border
-	BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector((float)(MazeLengthInTiles + 1) * TileSize, 0.f, FloorHeight));
-	BorderWall->SetActorScale3D(FVector(TileSize / 100.f, (float)((MazeLengthInTiles + 2) / 2) * TileSize / 100.f, OuterWallHeight / 100.f));
-
-	BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector((float)(MazeLengthInTiles + 1) * TileSize, (float)((MazeLengthInTiles + 2) / 2 + 1) * TileSize, FloorHeight));
-	BorderWall->SetActorScale3D(FVector(TileSize / 100.f, (float)((MazeLengthInTiles + 2) / 2) * TileSize / 100.f, OuterWallHeight / 100.f));
+	if (!(SkippedBorderSides & (1 << (uint8)EDirection::D_East))) {
+		const float Thickness = (DoubledBorderSides & (1 << (uint8)EDirection::D_East)) ? 2.f : 1.f;
+		SpawnBorderPiece(FVector(FarEdge * TileSize, 0.f, FloorHeight), Thickness, (float)HalfLength);
+		SpawnBorderPiece(FVector(FarEdge * TileSize, (float)(HalfLength + 1) * TileSize, FloorHeight), Thickness, (float)HalfLength);
+	}
 
 	//Top Border
-	BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector(TileSize, 0.f, FloorHeight));
-	BorderWall->SetActorScale3D(FVector((float)(MazeLengthInTiles / 2) * TileSize / 100.f, TileSize / 100.f, OuterWallHeight / 100.f));
-
-	BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector((float)((MazeLengthInTiles + 2) / 2 + 1) * TileSize, 0.f, FloorHeight));
-	BorderWall->SetActorScale3D(FVector((float)(MazeLengthInTiles / 2) * TileSize / 100.f, TileSize / 100.f, OuterWallHeight / 100.f));
+	if (!(SkippedBorderSides & (1 << (uint8)EDirection::D_North))) {
+		SpawnBorderPiece(FVector(TileSize, 0.f, FloorHeight), EdgeLength, 1.f);
+		SpawnBorderPiece(FVector((float)(HalfLength + 1) * TileSize, 0.f, FloorHeight), EdgeLength, 1.f);
+	}
 
 	//Bottom Border
-	BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector(TileSize, (float)(MazeLengthInTiles + 1) * TileSize, FloorHeight));
-	BorderWall->SetActorScale3D(FVector((float)(MazeLengthInTiles / 2) * TileSize / 100.f, TileSize / 100.f, OuterWallHeight / 100.f));
-
-	BorderWall = GetWorld()->SpawnActor(BorderClass);
-	BorderWall->SetActorLocation(GetActorLocation() + FVector((float)((MazeLengthInTiles + 2) / 2 + 1) * TileSize, (float)(MazeLengthInTiles + 1) * TileSize, FloorHeight));
-	BorderWall->SetActorScale3D(FVector((float)(MazeLengthInTiles / 2) * TileSize / 100.f, TileSize / 100.f, OuterWallHeight / 100.f));
-
-
-
+	if (!(SkippedBorderSides & (1 << (uint8)EDirection::D_South))) {
+		const float Thickness = (DoubledBorderSides & (1 << (uint8)EDirection::D_South)) ? 2.f : 1.f;
+		SpawnBorderPiece(FVector(TileSize, FarEdge * TileSize, FloorHeight), EdgeLength, Thickness);
+		SpawnBorderPiece(FVector((float)(HalfLength + 1) * TileSize, FarEdge * TileSize, FloorHeight), EdgeLength, Thickness);
+	}
+}
 
+void AMazeSegment::SpawnBorderPiece(const FVector& RelativeLocation, float TilesX, float TilesY) {
+	AActor* BorderWall = GetWorld()->SpawnActor(BorderClass);
+	BorderWall->SetActorLocation(GetActorLocation() + RelativeLocation);
+	BorderWall->SetActorScale3D(FVector(TilesX * TileSize / 100.f, TilesY * TileSize / 100.f, OuterWallHeight / 100.f));
 }
 
 // uint8 test = (uint8)ETileDesignation::TD_Cell;
@@ -804,4 +1014,62 @@ void AMazeSegment::SpawnBorders() {
 /*for (auto& currentTile : WallRow.Column) {
 testString = EnumPtr->GetEnumName((uint8)currentTile);
 GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, testString);
-}*/
\ No newline at end of file
+}*/
+
+#if WITH_EDITOR
+#include "MazeTestLayouts.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMazeSegmentBatchPathTest, "ProtoGauntlet.Maze.Segment.BatchMatchesSerial", EAutomationTestFlags::ATF_Editor)
+
+bool FMazeSegmentBatchPathTest::RunTest(const FString& Parameters) {
+	const int32 NumRequests = 1024;
+
+	AMazeSegment* Segment = NewObject<AMazeSegment>();
+	Segment->ChangeMazeParameters(81, 400.f, 100.f, 600.f, 800.f);
+	Segment->SetRandomSeed(4242);
+	Segment->PathfindingMode = EPathfindingMode::PM_AStar;
+	// Otherwise the serial side would be timed against its own path cache.
+	Segment->PathCacheCapacity = 0;
+	Segment->BuildLayout();
+	const FMazeTileGrid& Grid = Segment->GetGrid();
+
+	FMazeRandomStream Random(0xBA7C);
+	TArray<FMazePathRequest> Requests;
+	Requests.SetNum(NumRequests);
+	for (int32 i = 0; i < NumRequests; i++) {
+		Requests[i].StartPoint = FMazeTestLayouts::RandomPathTile(Grid, Random);
+		Requests[i].EndPoint = FMazeTestLayouts::RandomPathTile(Grid, Random);
+		Requests[i].StartDirection = i % 4 == 0 ? (EDirection)Random.RandRange(0, 3) : EDirection::D_None;
+	}
+
+	// One untimed pass so neither side pays for growing its scratch.
+	FMazePathBatchResult Result;
+	Segment->FindPathsBatch(Requests, Result);
+
+	double StartTime = FPlatformTime::Seconds();
+	Segment->FindPathsBatch(Requests, Result);
+	const double BatchSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TArray<int32> SerialLengths;
+	SerialLengths.SetNumUninitialized(NumRequests);
+	TArray<FIntPair> Path;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumRequests; i++) {
+		Path.Reset();
+		Segment->FindPathBetweenPoints(Requests[i].StartPoint, Requests[i].EndPoint, Path, Requests[i].StartDirection);
+		SerialLengths[i] = Path.Num();
+	}
+	const double SerialSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("One batch path per request"), Result.NumPaths(), NumRequests);
+	int32 Mismatches = 0;
+	for (int32 i = 0; i < Result.NumPaths(); i++) {
+		Mismatches += Result.Offsets[i + 1] - Result.Offsets[i] != SerialLengths[i];
+	}
+	TestEqual(TEXT("Batch path lengths disagree with FindPathBetweenPoints"), Mismatches, 0);
+
+	AddLogItem(FString::Printf(TEXT("%d requests on %dx%d: batch %.0f paths/s, serial %.0f paths/s"),
+		NumRequests, Grid.Width, Grid.Height, NumRequests / FMath::Max(BatchSeconds, 1e-9), NumRequests / FMath::Max(SerialSeconds, 1e-9)));
+	return true;
+}
+#endif
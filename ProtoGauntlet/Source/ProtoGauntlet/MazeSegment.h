@@ -4,8 +4,27 @@
 
 #include "GameFramework/Actor.h"
 #include "MyActor.h"
+#include "MazeTileGrid.h"
+#include "MazePathMasks.h"
+#include "MazeFlowField.h"
+#include "MazeAsyncPathQuery.h"
+#include "MazePathCache.h"
+#include "MazeWallInstances.h"
+#include "MazeWallAnimator.h"
+#include "MazeWallMerge.h"
+#include "MazeWallPool.h"
 #include "MazeSegment.generated.h"
 
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FMazePathQueryDelegate, int32, QueryId, bool, bFound, const TArray<FVector>&, Path);
+
+/** An async path query waiting to report back to its delegate. */
+struct FMazePendingPathQuery
+{
+	TSharedPtr<FMazePathQuery, ESPMode::ThreadSafe> Query;
+
+	FMazePathQueryDelegate OnComplete;
+};
+
 UCLASS()
 class PROTOGAUNTLET_API AMazeSegment : public AActor
 {
@@ -17,9 +36,109 @@ public:
 
 	void ChangeMazeParameters(int32 MazeLengthInTiles, float TileSize, float FloorHeight, float InnerWallHeight, float OuterWallHeight);
 
+	/**
+	 * Lets adjacent segments share one border. Sides in SkipSides are not spawned; sides in
+	 * DoubleSides are spawned two tiles thick, outward, to stand in for the neighbour's. Both
+	 * masks are EDirection bits and must be set before BeginPlay.
+	 */
+	void SetSharedBorders(uint8 SkipSides, uint8 DoubleSides);
+
+	/** Leaves the walls unspawned at BeginPlay until MaterializeWalls is called. Must be set before BeginPlay. */
+	void SetWallStreaming(bool bStreamWalls);
+
+	/**
+	 * Whether SpawnWalls can be run again to bring the walls back as they were. Segments whose
+	 * SpawnWalls also sets up gameplay state return false and are never streamed out.
+	 */
+	virtual bool SupportsWallStreaming() const;
+
+	/** Spawns the walls, restoring which were lowered when they were last streamed out. */
+	UFUNCTION(BlueprintCallable, Category = "Walls")
+	void MaterializeWalls();
+
+	/**
+	 * Hands every wall back to the pool, keeping only which tiles had one and which were
+	 * lowered. The layout and path caches are untouched. While streamed out, LowerWallAt and
+	 * RaiseWallAt update the kept state; timed and one-shot moves are dropped.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Walls")
+	void DematerializeWalls();
+
+	UFUNCTION(BlueprintCallable, Category = "Walls")
+	bool AreWallsMaterialized();
+
+	/** Seeds the streams, generates the layout into Grid and rebuilds the path caches. Game thread only. */
+	void BuildLayout();
+
+	/**
+	 * Like BuildLayout, but generates into a grid owned by the caller, never touching Grid,
+	 * which the garbage collector walks. A segment spawned deferred may be built this way on
+	 * a worker thread, then handed its grid with AdoptLayout on the game thread.
+	 *
+	 * Besides Target, this writes the random streams and everything RebuildLayoutCachesFrom
+	 * does: PathCache, PathMasks, TreeIndex, JunctionGraph, FlowFields, LayoutSnapshot,
+	 * bOpenLayout and LayoutVersion. None of it is locked, so while it runs off the game
+	 * thread nothing on the game thread may reach the segment until AdoptLayout and
+	 * FinishSpawning have been called.
+	 */
+	void BuildLayoutInto(FMazeTileGrid& Target);
+
+	/** Moves a grid made by BuildLayoutInto into Grid. Call on the game thread before FinishSpawning; BeginPlay then skips generation. */
+	void AdoptLayout(FMazeTileGrid& BuiltGrid);
+
 	UPROPERTY(BlueprintReadWrite, Category = "Pathfinding")
 	bool NavMeshReady;
 
+	/** Search used by FindPathBetweenPoints. Depth first, the default, returns a random path; the others return a shortest one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinding")
+	EPathfindingMode PathfindingMode;
+
+	/** Paths remembered by FindPathBetweenPoints in deterministic modes. Zero turns the cache off. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding")
+	int32 PathCacheCapacity;
+
+	/** Always search this layout as open ground with jump point search, whatever its measured openness. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding")
+	bool bOpenLayoutHint;
+
+	/** Share of fully open 2x2 tile blocks above which deterministic searches switch to jump point search. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pathfinding", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float OpenLayoutThreshold;
+
+	/** Whether deterministic searches currently use jump point search. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	bool IsOpenLayout();
+
+	/** Eller's algorithm keeps only one row of state while generating, for very tall segments. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Generation")
+	EMazeGenerationAlgorithm GenerationAlgorithm;
+
+	/** Seed for layout generation, shuffles and random walks. Zero picks a fresh one at BeginPlay. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Generation")
+	int32 RandomSeed;
+
+	/** Takes effect at BeginPlay, so set it on a deferred spawn to reproduce a layout. */
+	UFUNCTION(BlueprintCallable, Category = "Generation")
+	void SetRandomSeed(int32 Seed);
+
+	/** The seed in use, including one picked at BeginPlay. */
+	UFUNCTION(BlueprintCallable, Category = "Generation")
+	int32 GetRandomSeed();
+
+	/**
+	 * Generates a new layout from Seed, or a fresh seed if zero, and respawns the walls.
+	 * The old walls go back to the wall pool first, so with a warm pool nothing is spawned.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generation")
+	void RebuildLayout(int32 Seed = 0);
+
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	void GetPathCacheStats(int32 & Hits, int32 & Misses);
+
+	/** Bumped every time walkability changes. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	int32 GetLayoutVersion();
+
 	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
 	bool PathHasIntersectionBP(TArray<FVector> Path, int32 & IntersectionX, int32 & IntersectionY);
 
@@ -38,6 +157,49 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
 		void FindPathBetweenPointsBP(int32 StartPointX, int32 StartPointY, int32 EndPointX, int32 EndPointY, TArray<FVector> & Path, EDirection StartDirection = EDirection::D_None);
 
+	/**
+	 * Starts a path search on a worker thread and returns its query id. OnComplete runs on the
+	 * game thread with the path in world space, unless the query is cancelled first.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		int32 FindPathBetweenPointsAsync(FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, FMazePathQueryDelegate OnComplete);
+
+	/** Drops a pending async query. Its delegate will not be called. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		void CancelPathQuery(int32 QueryId);
+
+	/** Latent form of FindPathBetweenPointsBP. The search runs off the game thread; the node resumes when it is done. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding", meta = (Latent, LatentInfo = "LatentInfo"))
+		void FindPathBetweenPointsLatent(int32 StartPointX, int32 StartPointY, int32 EndPointX, int32 EndPointY, EDirection StartDirection, TArray<FVector> & Path, bool & bFound, FLatentActionInfo LatentInfo);
+
+	/**
+	 * Answers many path requests at once, spread over worker threads. Random depth first
+	 * mode is answered with A* here, since it cannot run off the game thread.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		void FindPathsBatch(const TArray<FMazePathRequest> & Requests, FMazePathBatchResult & Result);
+
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		void GetBatchPathBP(const FMazePathBatchResult & Result, int32 RequestIndex, TArray<FVector> & Path);
+
+	/** Steps on the shortest path between two tiles, or -1 if they are not connected. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		int32 GetPathLength(FIntPair StartPoint, FIntPair EndPoint);
+
+	/**
+	 * Next step from FromTile toward Target, or away from it if bFlee. All callers chasing the
+	 * same target share one field, rebuilt only when the target changes tile or the layout changes.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		EDirection GetFlowDirection(AActor* Target, FIntPair FromTile, bool bFlee = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		EDirection GetFlowDirectionAtLocation(AActor* Target, FVector Location, bool bFlee = false);
+
+	/** Steps from FromTile to Target's tile, or -1 if unreachable. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+		int32 GetFlowDistance(AActor* Target, FIntPair FromTile);
+
 	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
 		void GetAllTilesInSection(FIntPair StartPoint, TArray<FIntPair> & Result, EDirection StartDirection);
 
@@ -80,6 +242,57 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
 	bool GetPathfindingActive();
 
+	/** Lowers the wall on a tile, whether it is an actor or an instance, animated natively or in Blueprint. */
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	void LowerWallAt(int32 TileRow, int32 TileColumn);
+
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	void RaiseWallAt(int32 TileRow, int32 TileColumn);
+
+	/**
+	 * Deadly reaches Blueprint animated walls through RaiseAndLower, native wall actors
+	 * through OnWallMoveStarted, and instanced walls through OnDeadlyInstancedWallRise.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	void RaiseAndLowerWallAt(int32 TileRow, int32 TileColumn, bool Deadly = true);
+
+	/** An instanced wall has started a deadly rise; there is no actor to carry the damage, so the segment's Blueprint does. */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Raise and Lower")
+	void OnDeadlyInstancedWallRise(int32 TileRow, int32 TileColumn, float Duration);
+
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	void LowerAndRaiseWallAt(int32 TileRow, int32 TileColumn);
+
+	/** Lowers the wall, then raises it again after LoweredTime. */
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	void LowerWallOnTimerAt(int32 TileRow, int32 TileColumn, float LoweredTime);
+
+	/** Raises the wall, then lowers it again after RaisedTime. */
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	void RaiseWallOnTimerAt(int32 TileRow, int32 TileColumn, float RaisedTime);
+
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	bool HasWallAt(int32 TileRow, int32 TileColumn);
+
+	/** Whether the wall on a tile is down. A wall actor counts as down while its LowerEnabled is false. */
+	UFUNCTION(BlueprintCallable, Category = "Raise and Lower")
+	bool IsWallLoweredAt(int32 TileRow, int32 TileColumn);
+
+	FORCEINLINE const FMazeTileGrid& GetGrid() const
+	{
+		return Grid;
+	}
+
+	FORCEINLINE float GetTileSize() const
+	{
+		return TileSize;
+	}
+
+	FORCEINLINE float GetFloorHeight() const
+	{
+		return FloorHeight;
+	}
+
 protected:
 	UPROPERTY(EditDefaultsOnly)
 		TSubclassOf<AActor> BorderClass; 
@@ -90,6 +303,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dimensions")
 		float FloorHeight;
 
+	/** Row-major tile designations and wall references for the whole segment. */
+	UPROPERTY(BlueprintReadOnly)
+		FMazeTileGrid Grid;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dimensions")
 		float HalfTileSize;
 
@@ -106,28 +323,188 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dimensions")
 		float OuterWallHeight;
 
+	/** Frozen layout handed to async queries, made on first use after each layout change. */
+	TSharedPtr<const FMazeLayoutSnapshot, ESPMode::ThreadSafe> LayoutSnapshot;
+
+	int32 NextPathQueryId;
+
+	TMap<int32, FMazePendingPathQuery> PendingPathQueries;
+
+	/** Path lengths of the batch in flight, indexed by request. */
+	TArray<int32> BatchPathLengths;
+
+	/** Per-chunk scratch and output for FindPathsBatch, kept to avoid reallocating. */
+	TArray<FMazeSearchScratch> BatchScratch;
+
+	TArray<TArray<FIntPair>> BatchTiles;
+
+	/** Flow fields per target actor and direction, dropped whenever the layout changes. */
+	TArray<FMazeTargetFlowField> FlowFields;
+
+	/** Corridors and junctions, plus the next junction in each direction from every tile. */
+	FMazeJunctionGraph JunctionGraph;
+
+	uint32 LayoutVersion;
+
+	/** Set by RebuildLayoutCaches from bOpenLayoutHint and the measured openness. */
+	bool bOpenLayout;
+
+	FMazePathCache PathCache;
+
+	/** Whole-grid neighbor classification, rebuilt whenever the layout changes. */
+	FMazePathMasks PathMasks;
+
 	bool PathfindingActive;
 
-	UPROPERTY(BlueprintReadOnly)
-		TArray<FMazeRowData> Row;
+	/** Generation and shuffle choices, seeded from RandomSeed. */
+	FMazeRandomStream RandomStream;
+
+	/** Set once BuildLayout has run, whether at BeginPlay or ahead of it. */
+	bool bLayoutBuilt;
+
+	/** Visited stamps and stacks shared by the game thread pathfinding queries. */
+	FMazeSearchScratch SearchScratch;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dimensions")
 		float TileSize;
 
+	/** Unique-path lookups, valid while the layout is a perfect maze. */
+	FMazeTreeIndex TreeIndex;
+
 	UPROPERTY(EditDefaultsOnly)
 		TSubclassOf<AMazeWall> WallClass;
 
+	/** Draw inner walls as instances of WallMesh instead of spawning a WallClass actor per tile. */
+	UPROPERTY(EditDefaultsOnly, Category = "Walls")
+		bool bUseInstancedWalls;
+
+	/** Unit cube sized mesh for instanced walls, scaled like the wall actors. */
+	UPROPERTY(EditDefaultsOnly, Category = "Walls")
+		UStaticMesh* WallMesh;
+
+	/**
+	 * Cover wall tiles with as few rectangles as possible and spawn one scaled piece per
+	 * rectangle. Per-tile wall queries still work, but raising or lowering a tile moves its
+	 * whole piece, so leave this off for layouts that change.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Walls")
+		bool bMergeStaticWalls;
+
+	/** Border sides, as EDirection bits, left for a neighbouring segment to spawn. */
+	uint8 SkippedBorderSides;
+
+	/** Border sides, as EDirection bits, spawned two tiles thick to cover a skipped neighbour's border too. */
+	uint8 DoubledBorderSides;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Walls")
+		USceneComponent* SceneRoot;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Walls")
+		UMazeWallInstances* WallInstances;
+
+	/**
+	 * Move wall actors with WallAnimator rather than their own Blueprint timelines. Their
+	 * Raise and Lower events are then skipped and OnWallMoveStarted fires instead, for
+	 * cosmetics. Instanced walls are always animated natively.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Walls")
+		bool bNativeWallAnimation;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Walls")
+		UMazeWallAnimator* WallAnimator;
+
+	/** Animator slot for a tile's wall, or INDEX_NONE if the wall animates itself in Blueprint or there is none. */
+	int32 GetAnimatorSlot(int32 TileRow, int32 TileColumn) const;
+
+	/** The wall actor on a tile, or null. */
+	AMazeWall* GetBlueprintWall(int32 TileRow, int32 TileColumn) const;
+
+	/** Empties the instanced walls and the animator, sized for the current grid. */
+	void ResetWallState();
+
+	/** Source of wall actors, if the level has one. */
+	TWeakObjectPtr<AMazeWallPool> WallPool;
+
+	/** Hands every wall actor back to the pool, or destroys it without one, and drops all instances. */
+	void ReleaseWalls();
+
+	/** Walls a subclass places itself across many tiles, outside Grid.Walls. ReleaseWalls hands them back too. */
+	UPROPERTY()
+		TArray<AMazeWall*> SpanningWalls;
+
+	/** A WallClass actor from the pool, or freshly spawned without one. Null if none could be had. */
+	AMazeWall* AcquireWall();
+
+	/** Places an acquired wall at RelativeLocation with Scale and tracks it in SpanningWalls. */
+	AMazeWall* SpawnSpanningWall(const FVector& RelativeLocation, const FVector& Scale);
+
+	bool bStreamWalls;
+
+	bool bWallsMaterialized;
+
+	/** Tiles that held a wall and tiles whose wall was lowered, kept while streamed out. Empty otherwise. */
+	TBitArray<> StreamedWallTiles;
+
+	TBitArray<> StreamedLoweredTiles;
+
+	/** Index into the streamed wall state for a tile, or INDEX_NONE while the walls are live or none was kept. */
+	int32 GetStreamedTile(int32 TileRow, int32 TileColumn) const;
+
+	/** Whether SpawnWallAt adds instances rather than actors. Fixed once walls have been spawned. */
+	bool UsesInstancedWalls() const;
+
+	/**
+	 * Puts a wall on a tile. RelativeLocation is the raised position relative to the segment;
+	 * a wall started lowered sits InnerWallHeight below it.
+	 */
+	void SpawnWallAt(int32 TileRow, int32 TileColumn, const FVector& RelativeLocation, bool bStartLowered = false);
+
+	/** Spawns one wall piece covering Rect; RelativeLocation is its raised corner nearest the origin. */
+	void SpawnWallPiece(const FMazeWallRect& Rect, const FVector& RelativeLocation, bool bStartLowered = false);
+
+	/** A border piece TilesX by TilesY tiles, with its corner at RelativeLocation. */
+	void SpawnBorderPiece(const FVector& RelativeLocation, float TilesX, float TilesY);
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	void CalculateValues();
 
-	virtual void CreateMazeLayout();
+	/**
+	 * Sizes and fills Target with this segment's layout, touching only Target and RandomStream.
+	 * Runs on a worker thread under BuildLayoutInto, whose rules apply to overrides too.
+	 */
+	virtual void CreateMazeLayout(FMazeTileGrid& Target);
+
+	/** Fills an already sized grid's tiles with a fresh maze from GenerationAlgorithm. Wall references are left alone. */
+	void GenerateLayout(FMazeTileGrid& Target, FMazeRandomStream& Random) const;
+
+	static void GenerateRecursiveBacktracker(FMazeTileGrid& Target, FMazeRandomStream& Random);
+
+	/** Path query against the layout caches only. Safe to call from several threads with separate scratch. */
+	bool FindPathUsing(FMazeSearchScratch& Scratch, EPathfindingMode Mode, FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) const;
+
+	/** Starts a background search against the current layout snapshot. */
+	TSharedRef<FMazePathQuery, ESPMode::ThreadSafe> StartPathQuery(FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TFunction<void()> OnGameThread);
+
+	/** Delivers a finished async query to its delegate. */
+	void CompletePathQuery(int32 QueryId);
+
+	/** The field for Target, rebuilt first if Target has moved tiles. Null for a null Target. */
+	const FMazeFlowField* GetFlowField(AActor* Target, bool bFlee);
 
 	virtual void PostInitProperties() override;
 
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 
+	/** Recomputes everything derived from Grid and bumps LayoutVersion. Call after any change to tile designations. */
+	void RebuildLayoutCaches();
+
+	/** RebuildLayoutCaches against a grid that has not been moved into Grid yet. Writes the same members, so the same threading rules as BuildLayoutInto apply. */
+	void RebuildLayoutCachesFrom(const FMazeTileGrid& Source);
+
 	virtual void SpawnBorders();
 	
 	virtual void SpawnFloor();
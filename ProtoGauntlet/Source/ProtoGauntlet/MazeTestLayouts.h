@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#if WITH_EDITOR
+
+#include "MazeEllerGenerator.h"
+#include "MazeTileGrid.h"
+
+/** Seeded layouts shared by the maze automation tests. */
+struct FMazeTestLayouts
+{
+	/** Every tile independently path with probability PathChance, no lattice at all. */
+	static void MakeNoise(FMazeTileGrid& Grid, int32 Width, int32 Height, float PathChance, FMazeRandomStream& Random)
+	{
+		Grid.Init(Width, Height, ETileDesignation::TD_Wall);
+		for (int32 i = 0; i < Grid.Num(); i++) {
+			if (Random.FRand() < PathChance) {
+				Grid.Tiles[i] = ETileDesignation::TD_Path;
+			}
+		}
+	}
+
+	/** A perfect maze, as the segments generate it. Width and Height should be odd. */
+	static void MakePerfect(FMazeTileGrid& Grid, int32 Width, int32 Height, FMazeRandomStream& Random)
+	{
+		Grid.Init(Width, Height, ETileDesignation::TD_Wall);
+		FMazeEllerGenerator::Generate(Width, Height, Random, [&Grid](int32 TileRow, const TArray<ETileDesignation>& Tiles) {
+			Grid.SetRow(TileRow, Tiles);
+		});
+	}
+
+	/** Opens up to Count walls that sit between two cells, so the maze gains loops. */
+	static void AddLoops(FMazeTileGrid& Grid, int32 Count, FMazeRandomStream& Random)
+	{
+		for (int32 i = 0; i < Count; i++) {
+			const int32 TileRow = Random.RandRange(0, Grid.Height - 1);
+			const int32 TileColumn = Random.RandRange(0, Grid.Width - 1);
+			if ((TileRow % 2 == 1) != (TileColumn % 2 == 1)) {
+				Grid.Set(TileRow, TileColumn, ETileDesignation::TD_Path);
+			}
+		}
+	}
+
+	/** Open ground with isolated wall tiles scattered at WallChance, like an arena floor. */
+	static void MakeOpen(FMazeTileGrid& Grid, int32 Width, int32 Height, float WallChance, FMazeRandomStream& Random)
+	{
+		Grid.Init(Width, Height, ETileDesignation::TD_Path);
+		for (int32 i = 0; i < Grid.Num(); i++) {
+			if (Random.FRand() < WallChance) {
+				Grid.Tiles[i] = ETileDesignation::TD_Wall;
+			}
+		}
+	}
+
+	/** A uniformly chosen path tile. The grid must have at least one. */
+	static FIntPair RandomPathTile(const FMazeTileGrid& Grid, FMazeRandomStream& Random)
+	{
+		for (;;) {
+			const int32 TileIndex = Random.RandRange(0, Grid.Num() - 1);
+			if (Grid.Tiles[TileIndex] == ETileDesignation::TD_Path) {
+				return FIntPair(TileIndex % Grid.Width, TileIndex / Grid.Width);
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MyActor.h"
+#include "MazeTileGrid.generated.h"
+
+/**
+ * Row-major tile store for a maze segment. Tiles and wall references each live in
+ * a single contiguous array and are addressed with TileRow * Width + TileColumn.
+ */
+USTRUCT(BlueprintType)
+struct FMazeTileGrid
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Tile Grid")
+	int32 Width;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Tile Grid")
+	int32 Height;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Tile Grid")
+	TArray<ETileDesignation> Tiles;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Tile Grid")
+	TArray<AMazeWall*> Walls;
+
+	FMazeTileGrid()
+	{
+		Width = 0;
+		Height = 0;
+	}
+
+	/** Resizes the grid and fills every tile with Fill. Wall references are cleared. */
+	void Init(int32 InWidth, int32 InHeight, ETileDesignation Fill)
+	{
+		Width = InWidth;
+		Height = InHeight;
+		Tiles.Init(Fill, Width * Height);
+		Walls.Init(nullptr, Width * Height);
+	}
+
+	/** Resizes the grid to the recursive backtracker starting pattern. */
+	void InitCells(int32 InWidth, int32 InHeight)
+	{
+		Init(InWidth, InHeight, ETileDesignation::TD_Wall);
+		ResetCells();
+	}
+
+	/** Cells on even/even tiles, walls everywhere else. Wall references are kept. */
+	void ResetCells()
+	{
+		for (int32 y = 0; y < Height; y++) {
+			ETileDesignation* RowData = Tiles.GetData() + y * Width;
+			for (int32 x = 0; x < Width; x++) {
+				RowData[x] = ETileDesignation::TD_Wall;
+			}
+		}
+		for (int32 y = 0; y < Height; y += 2) {
+			ETileDesignation* RowData = Tiles.GetData() + y * Width;
+			for (int32 x = 0; x < Width; x += 2) {
+				RowData[x] = ETileDesignation::TD_Cell;
+			}
+		}
+	}
+
+	FORCEINLINE int32 Num() const
+	{
+		return Tiles.Num();
+	}
+
+	FORCEINLINE int32 Index(int32 TileRow, int32 TileColumn) const
+	{
+		return TileRow * Width + TileColumn;
+	}
+
+	FORCEINLINE bool IsValid(int32 TileRow, int32 TileColumn) const
+	{
+		return TileColumn >= 0 && TileRow >= 0 && TileColumn < Width && TileRow < Height;
+	}
+
+	FORCEINLINE ETileDesignation Get(int32 TileRow, int32 TileColumn) const
+	{
+		return Tiles[TileRow * Width + TileColumn];
+	}
+
+	FORCEINLINE void Set(int32 TileRow, int32 TileColumn, ETileDesignation Designation)
+	{
+		Tiles[TileRow * Width + TileColumn] = Designation;
+	}
+
+	/** Overwrites a whole row of designations, as handed over by a row generator. Wall references are kept. */
+	void SetRow(int32 TileRow, const TArray<ETileDesignation>& Row)
+	{
+		check(Row.Num() == Width);
+		FMemory::Memcpy(Tiles.GetData() + TileRow * Width, Row.GetData(), Width * sizeof(ETileDesignation));
+	}
+
+	/** Bounds-checked walkability test. */
+	FORCEINLINE bool IsPath(int32 TileRow, int32 TileColumn) const
+	{
+		return IsValid(TileRow, TileColumn) && Tiles[TileRow * Width + TileColumn] == ETileDesignation::TD_Path;
+	}
+
+	FORCEINLINE AMazeWall* GetWall(int32 TileRow, int32 TileColumn) const
+	{
+		return Walls[TileRow * Width + TileColumn];
+	}
+
+	FORCEINLINE void SetWall(int32 TileRow, int32 TileColumn, AMazeWall* Wall)
+	{
+		Walls[TileRow * Width + TileColumn] = Wall;
+	}
+
+	/** The tile one step from Tile in Direction. D_None returns Tile. */
+	static FORCEINLINE FIntPair Step(FIntPair Tile, EDirection Direction)
+	{
+		switch (Direction) {
+		case EDirection::D_North: return FIntPair(Tile.x, Tile.y - 1);
+		case EDirection::D_East: return FIntPair(Tile.x + 1, Tile.y);
+		case EDirection::D_South: return FIntPair(Tile.x, Tile.y + 1);
+		case EDirection::D_West: return FIntPair(Tile.x - 1, Tile.y);
+		default: return Tile;
+		}
+	}
+};
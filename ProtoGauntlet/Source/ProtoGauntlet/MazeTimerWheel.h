@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Hashed timer wheel. Time is cut into fixed ticks and a timer lands in the bucket for its
+ * due tick modulo the wheel size, with a count of whole turns still to wait. Scheduling is
+ * O(1) and advancing visits only the buckets passed, however many timers are pending.
+ */
+template<typename PayloadType>
+class TMazeTimerWheel
+{
+public:
+	TMazeTimerWheel()
+	{
+		Init(1.f / 30.f, 256);
+	}
+
+	/** Empties the wheel. NumBuckets is rounded up to a power of two. */
+	void Init(float InResolution, int32 NumBuckets)
+	{
+		Resolution = FMath::Max(InResolution, KINDA_SMALL_NUMBER);
+		Buckets.Reset();
+		Buckets.SetNum(1 << FMath::CeilLogTwo((uint32)FMath::Max(NumBuckets, 1)));
+		Mask = Buckets.Num() - 1;
+		CurrentTick = 0;
+		Accumulated = 0.f;
+		NumPending = 0;
+	}
+
+	/** Fires Payload Delay seconds from now, rounded up to the next tick. */
+	void Schedule(float Delay, const PayloadType& Payload)
+	{
+		const int32 Ticks = FMath::Max(1, (int32)FMath::CeilToFloat((Delay + Accumulated) / Resolution));
+		TArray<FTimer>& Bucket = Buckets[(int32)((CurrentTick + Ticks) & Mask)];
+		FTimer& Timer = Bucket[Bucket.AddUninitialized()];
+		Timer.Payload = Payload;
+		Timer.Rounds = (Ticks - 1) / Buckets.Num();
+		NumPending++;
+	}
+
+	/** Moves time on by DeltaTime and calls Fire for every timer that came due. Fire may schedule more. */
+	template<typename FireType>
+	void Advance(float DeltaTime, FireType&& Fire)
+	{
+		Accumulated += DeltaTime;
+		while (Accumulated >= Resolution) {
+			Accumulated -= Resolution;
+			CurrentTick++;
+
+			// Work from a swapped out copy so timers scheduled by Fire wait for their own turn.
+			TArray<FTimer>& Bucket = Buckets[(int32)(CurrentTick & Mask)];
+			Exchange(Firing, Bucket);
+			for (FTimer& Timer : Firing) {
+				if (Timer.Rounds > 0) {
+					Timer.Rounds--;
+					Bucket.Add(Timer);
+				} else {
+					NumPending--;
+					Fire(Timer.Payload);
+				}
+			}
+			Firing.Reset();
+		}
+	}
+
+	FORCEINLINE int32 Num() const
+	{
+		return NumPending;
+	}
+
+private:
+	struct FTimer
+	{
+		PayloadType Payload;
+
+		int32 Rounds;
+	};
+
+	TArray<TArray<FTimer>> Buckets;
+
+	TArray<FTimer> Firing;
+
+	int64 CurrentTick;
+
+	int32 Mask;
+
+	int32 NumPending;
+
+	float Resolution;
+
+	/** Time since the last whole tick. */
+	float Accumulated;
+};
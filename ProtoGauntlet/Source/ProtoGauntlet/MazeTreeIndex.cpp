@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeTreeIndex.h"
+
+void FMazeTreeIndex::Build(const FMazeTileGrid& Grid) {
+	Width = Grid.Width;
+	Height = Grid.Height;
+	const int32 NumTiles = Grid.Num();
+
+	Depth.Init(INDEX_NONE, NumTiles);
+	Component.Init(INDEX_NONE, NumTiles);
+	Ancestors.SetNumUninitialized(NumTiles);
+
+	// A graph is a forest exactly when it has one edge fewer than nodes per component.
+	int32 PathTiles = 0;
+	int32 Edges = 0;
+	for (int32 y = 0; y < Height; y++) {
+		for (int32 x = 0; x < Width; x++) {
+			if (Grid.Get(y, x) == ETileDesignation::TD_Path) {
+				PathTiles++;
+				Edges += Grid.IsPath(y, x + 1) ? 1 : 0;
+				Edges += Grid.IsPath(y + 1, x) ? 1 : 0;
+			}
+		}
+	}
+
+	int32 Components = 0;
+	int32 MaxDepth = 0;
+	TArray<int32> Queue;
+	Queue.Reserve(PathTiles);
+	for (int32 TileIndex = 0; TileIndex < NumTiles; TileIndex++) {
+		Ancestors[TileIndex] = TileIndex;
+	}
+	for (int32 Root = 0; Root < NumTiles; Root++) {
+		if (Grid.Tiles[Root] != ETileDesignation::TD_Path || Depth[Root] != INDEX_NONE) {
+			continue;
+		}
+
+		Components++;
+		Depth[Root] = 0;
+		Component[Root] = Root;
+		Queue.Reset();
+		Queue.Add(Root);
+		for (int32 Head = 0; Head < Queue.Num(); Head++) {
+			const int32 Current = Queue[Head];
+			const FIntPair CurrentTile(Current % Width, Current / Width);
+			for (uint8 Direction = 0; Direction < 4; Direction++) {
+				const FIntPair Neighbor = FMazeTileGrid::Step(CurrentTile, (EDirection)Direction);
+				if (!Grid.IsPath(Neighbor.y, Neighbor.x)) {
+					continue;
+				}
+
+				const int32 NeighborIndex = Grid.Index(Neighbor.y, Neighbor.x);
+				if (Depth[NeighborIndex] == INDEX_NONE) {
+					Depth[NeighborIndex] = Depth[Current] + 1;
+					Component[NeighborIndex] = Root;
+					Ancestors[NeighborIndex] = Current;
+					MaxDepth = FMath::Max(MaxDepth, Depth[NeighborIndex]);
+					Queue.Add(NeighborIndex);
+				}
+			}
+		}
+	}
+
+	bIsTree = Edges == PathTiles - Components;
+	if (!bIsTree) {
+		Levels = 0;
+		return;
+	}
+
+	Levels = 1;
+	while ((1 << Levels) <= MaxDepth) {
+		Levels++;
+	}
+
+	Ancestors.SetNumUninitialized(Levels * NumTiles);
+	for (int32 Level = 1; Level < Levels; Level++) {
+		const int32* Previous = Ancestors.GetData() + (Level - 1) * NumTiles;
+		int32* Current = Ancestors.GetData() + Level * NumTiles;
+		for (int32 TileIndex = 0; TileIndex < NumTiles; TileIndex++) {
+			Current[TileIndex] = Previous[Previous[TileIndex]];
+		}
+	}
+}
+
+int32 FMazeTreeIndex::Lift(int32 TileIndex, int32 Steps) const {
+	for (int32 Level = 0; Steps != 0; Level++, Steps >>= 1) {
+		if (Steps & 1) {
+			TileIndex = Ancestor(Level, TileIndex);
+		}
+	}
+	return TileIndex;
+}
+
+int32 FMazeTreeIndex::CommonAncestor(int32 A, int32 B) const {
+	if (Depth[A] < Depth[B]) {
+		Swap(A, B);
+	}
+	A = Lift(A, Depth[A] - Depth[B]);
+	if (A == B) {
+		return A;
+	}
+
+	for (int32 Level = Levels - 1; Level >= 0; Level--) {
+		if (Ancestor(Level, A) != Ancestor(Level, B)) {
+			A = Ancestor(Level, A);
+			B = Ancestor(Level, B);
+		}
+	}
+	return Parent(A);
+}
+
+int32 FMazeTreeIndex::GetPathLength(FIntPair StartPoint, FIntPair EndPoint) const {
+	if (!bIsTree || !Contains(StartPoint) || !Contains(EndPoint)) {
+		return INDEX_NONE;
+	}
+
+	const int32 StartIndex = StartPoint.y * Width + StartPoint.x;
+	const int32 EndIndex = EndPoint.y * Width + EndPoint.x;
+	if (Component[StartIndex] != Component[EndIndex]) {
+		return INDEX_NONE;
+	}
+	return Depth[StartIndex] + Depth[EndIndex] - 2 * Depth[CommonAncestor(StartIndex, EndIndex)];
+}
+
+bool FMazeTreeIndex::FindPath(FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) const {
+	if (!bIsTree || !Contains(StartPoint) || !Contains(EndPoint)) {
+		return false;
+	}
+
+	const int32 StartIndex = StartPoint.y * Width + StartPoint.x;
+	const int32 EndIndex = EndPoint.y * Width + EndPoint.x;
+	if (Component[StartIndex] != Component[EndIndex]) {
+		return false;
+	}
+
+	const FIntPair Heading = FMazeTileGrid::Step(StartPoint, StartDirection);
+	if (StartDirection != EDirection::D_None && !Contains(Heading)) {
+		return false;
+	}
+
+	if (StartIndex == EndIndex) {
+		Path.Add(StartPoint);
+		return true;
+	}
+
+	const int32 Meet = CommonAncestor(StartIndex, EndIndex);
+	const int32 DownSteps = Depth[EndIndex] - Depth[Meet];
+
+	// The route is unique, so a heading that disagrees with its first step rules it out.
+	if (StartDirection != EDirection::D_None) {
+		const int32 FirstStep = StartIndex != Meet ? Parent(StartIndex) : Lift(EndIndex, DownSteps - 1);
+		if (FirstStep != Heading.y * Width + Heading.x) {
+			return false;
+		}
+	}
+
+	Path.Reserve(Path.Num() + Depth[StartIndex] - Depth[Meet] + DownSteps + 1);
+	for (int32 TileIndex = StartIndex; TileIndex != Meet; TileIndex = Parent(TileIndex)) {
+		Path.Add(FIntPair(TileIndex % Width, TileIndex / Width));
+	}
+	Path.Add(FIntPair(Meet % Width, Meet / Width));
+
+	// Walk up from the end, filling the tail of the path backwards.
+	const int32 TailStart = Path.Num();
+	Path.AddUninitialized(DownSteps);
+	int32 TileIndex = EndIndex;
+	for (int32 i = TailStart + DownSteps - 1; i >= TailStart; i--) {
+		Path[i] = FIntPair(TileIndex % Width, TileIndex / Width);
+		TileIndex = Parent(TileIndex);
+	}
+	return true;
+}
+
+#if WITH_EDITOR
+#include "MazePathfinder.h"
+#include "MazeTestLayouts.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMazeTreeIndexLengthTest, "ProtoGauntlet.Maze.TreeIndex.MatchesBreadthFirst", EAutomationTestFlags::ATF_Editor)
+
+bool FMazeTreeIndexLengthTest::RunTest(const FString& Parameters) {
+	const int32 Seeds[] = { 1, 7, 42, 1337, 90210 };
+	const int32 PairsPerSeed = 200;
+
+	for (int32 Seed : Seeds) {
+		FMazeRandomStream Random(Seed);
+		FMazeTileGrid Grid;
+		FMazeTestLayouts::MakePerfect(Grid, 41, 31, Random);
+
+		FMazeTreeIndex TreeIndex;
+		TreeIndex.Build(Grid);
+		TestTrue(FString::Printf(TEXT("Perfect maze indexed for seed %d"), Seed), TreeIndex.IsValid());
+
+		FMazeSearchScratch Scratch;
+		TArray<FIntPair> Path;
+		int32 Mismatches = 0;
+		for (int32 i = 0; i < PairsPerSeed; i++) {
+			const FIntPair Start = FMazeTestLayouts::RandomPathTile(Grid, Random);
+			const FIntPair End = FMazeTestLayouts::RandomPathTile(Grid, Random);
+
+			Path.Reset();
+			const int32 Expected = FMazePathfinder::FindPathBreadthFirst(Grid, Scratch, Start, End, EDirection::D_None, Path) ? Path.Num() - 1 : INDEX_NONE;
+			Mismatches += TreeIndex.GetPathLength(Start, End) != Expected;
+
+			Path.Reset();
+			TreeIndex.FindPath(Start, End, EDirection::D_None, Path);
+			Mismatches += Path.Num() - 1 != Expected;
+		}
+		TestEqual(FString::Printf(TEXT("Tree index lengths disagree with breadth-first search for seed %d"), Seed), Mismatches, 0);
+
+		FMazeTestLayouts::AddLoops(Grid, 20, Random);
+		TreeIndex.Build(Grid);
+		TestFalse(FString::Printf(TEXT("Maze with loops left indexed for seed %d"), Seed), TreeIndex.IsValid());
+	}
+	return true;
+}
+#endif
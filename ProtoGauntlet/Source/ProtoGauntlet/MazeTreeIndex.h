@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeTileGrid.h"
+
+/**
+ * Ancestor table over the path tiles of a perfect maze. When the path tiles form a
+ * forest (no loops) the route between two tiles is unique, so it can be read straight
+ * off parent pointers: lengths come from depths and a binary lifting lowest common
+ * ancestor in O(log n), and paths are extracted in O(path length) with no search.
+ *
+ * Layouts with loops, such as open center pieces, are detected in Build and leave the
+ * index invalid so callers fall back to a search.
+ */
+struct FMazeTreeIndex
+{
+	FMazeTreeIndex()
+	{
+		Width = 0;
+		Height = 0;
+		Levels = 0;
+		bIsTree = false;
+	}
+
+	/** Rebuilds the parent, depth and ancestor tables from the path tiles of Grid. */
+	void Build(const FMazeTileGrid& Grid);
+
+	/** True if the last Build found no loops. Queries are only meaningful when this holds. */
+	FORCEINLINE bool IsValid() const
+	{
+		return bIsTree;
+	}
+
+	/** True if Tile is a path tile covered by the index. */
+	FORCEINLINE bool Contains(FIntPair Tile) const
+	{
+		return Tile.x >= 0 && Tile.y >= 0 && Tile.x < Width && Tile.y < Height && Depth[Tile.y * Width + Tile.x] != INDEX_NONE;
+	}
+
+	/** Steps between two indexed tiles, or INDEX_NONE if they are not connected. */
+	int32 GetPathLength(FIntPair StartPoint, FIntPair EndPoint) const;
+
+	/**
+	 * Appends the unique path from StartPoint to EndPoint inclusive. With a StartDirection
+	 * the first step must go that way. Returns false, appending nothing, if there is no path.
+	 */
+	bool FindPath(FIntPair StartPoint, FIntPair EndPoint, EDirection StartDirection, TArray<FIntPair>& Path) const;
+
+private:
+
+	int32 Width;
+
+	int32 Height;
+
+	/** Rows in Ancestors. Enough that 1 << Levels exceeds the deepest tile. */
+	int32 Levels;
+
+	bool bIsTree;
+
+	/** Steps from the root of the tile's component, or INDEX_NONE for non-path tiles. */
+	TArray<int32> Depth;
+
+	/** Root tile index of each path tile's component. */
+	TArray<int32> Component;
+
+	/** Row k holds the 2^k-th ancestor of every tile; roots are their own ancestors. */
+	TArray<int32> Ancestors;
+
+	FORCEINLINE int32 Ancestor(int32 Level, int32 TileIndex) const
+	{
+		return Ancestors[Level * Depth.Num() + TileIndex];
+	}
+
+	FORCEINLINE int32 Parent(int32 TileIndex) const
+	{
+		return Ancestors[TileIndex];
+	}
+
+	/** The ancestor Steps levels above TileIndex. Steps must not exceed the tile's depth. */
+	int32 Lift(int32 TileIndex, int32 Steps) const;
+
+	/** Lowest common ancestor of two tiles in the same component. */
+	int32 CommonAncestor(int32 A, int32 B) const;
+};
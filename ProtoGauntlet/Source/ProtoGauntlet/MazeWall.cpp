@@ -2,6 +2,7 @@
 
 #include "ProtoGauntlet.h"
 #include "MazeWall.h"
+#include "Components/TimelineComponent.h"
 
 
 // Sets default values
@@ -27,3 +28,12 @@ void AMazeWall::Tick( float DeltaTime )
 
 }
 
+void AMazeWall::ResetForPool_Implementation() {
+	TArray<UTimelineComponent*> Timelines;
+	GetComponents(Timelines);
+	for (UTimelineComponent* Timeline : Timelines) {
+		Timeline->Stop();
+	}
+	LowerEnabled = true;
+	RaiseEnabled = true;
+}
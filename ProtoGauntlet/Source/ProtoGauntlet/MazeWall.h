@@ -38,6 +38,23 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable, Category = "Raise and Lower")
 	void LowerAndRaise();
 
+	/**
+	 * Fired when the segment's native animator starts moving this wall. The move itself is
+	 * handled; this is for sound and effects, and for arming damage when bDeadly is set on
+	 * the rise of a deadly raise and lower.
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Raise and Lower")
+	void OnWallMoveStarted(bool bRising, float Duration, bool bDeadly);
+
+	/**
+	 * Called as the wall goes back to the pool. Stops every timeline and re-enables raising
+	 * and lowering; a Blueprint that moves components in its timelines should also put them
+	 * back in the raised pose, after calling the parent.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Raise and Lower")
+	void ResetForPool();
+	virtual void ResetForPool_Implementation();
+
 	UPROPERTY(BlueprintReadWrite, Category = "Raise and Lower")
 	bool LowerEnabled;
 
@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeWallAnimator.h"
+#include "MazeWallInstances.h"
+#include "MazeWall.h"
+
+UMazeWallAnimator::UMazeWallAnimator()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	RaiseDuration = 0.5f;
+	LowerDuration = 0.5f;
+	HoldTime = 0.5f;
+	RaiseCurve = EMazeWallCurve::WC_RisingSine;
+	LowerCurve = EMazeWallCurve::WC_Sine;
+	TimerResolution = 1.f / 30.f;
+	WallInstances = nullptr;
+	Clock = 0.f;
+}
+
+void UMazeWallAnimator::Reset(int32 NumTiles, UMazeWallInstances* InWallInstances) {
+	WallInstances = InWallInstances;
+	TileToSlot.Init(INDEX_NONE, NumTiles);
+	Actors.Reset();
+	Instances.Reset();
+	RaisedZ.Reset();
+	LoweredZ.Reset();
+	CurrentZ.Reset();
+	FromZ.Reset();
+	ToZ.Reset();
+	StartTime.Reset();
+	Duration.Reset();
+	Curves.Reset();
+	Generations.Reset();
+	ActiveIndex.Reset();
+	ActiveSlots.Reset();
+	Timers.Init(TimerResolution, 256);
+	SetComponentTickEnabled(false);
+}
+
+int32 UMazeWallAnimator::AddWall(AMazeWall* Actor, int32 Instance, float InRaisedZ, float InLoweredZ, bool bStartLowered) {
+	const float StartZ = bStartLowered ? InLoweredZ : InRaisedZ;
+	const int32 Slot = Actors.Add(Actor);
+	Instances.Add(Instance);
+	RaisedZ.Add(InRaisedZ);
+	LoweredZ.Add(InLoweredZ);
+	CurrentZ.Add(StartZ);
+	FromZ.Add(StartZ);
+	ToZ.Add(StartZ);
+	StartTime.Add(0.f);
+	Duration.Add(0.f);
+	Curves.Add(EMazeWallCurve::WC_Linear);
+	Generations.Add(0);
+	ActiveIndex.Add(INDEX_NONE);
+	return Slot;
+}
+
+void UMazeWallAnimator::MapTile(int32 TileIndex, int32 Slot) {
+	if (TileToSlot.IsValidIndex(TileIndex)) {
+		TileToSlot[TileIndex] = Slot;
+	}
+}
+
+void UMazeWallAnimator::Lower(int32 Slot, float Delay) {
+	if (Actors.IsValidIndex(Slot)) {
+		Generations[Slot]++;
+		Schedule(Slot, true, Delay);
+	}
+}
+
+void UMazeWallAnimator::Raise(int32 Slot, float Delay) {
+	if (Actors.IsValidIndex(Slot)) {
+		Generations[Slot]++;
+		Schedule(Slot, false, Delay);
+	}
+}
+
+void UMazeWallAnimator::RaiseAndLower(int32 Slot, bool bDeadly) {
+	RaiseFor(Slot, RaiseDuration + HoldTime, bDeadly);
+}
+
+void UMazeWallAnimator::LowerAndRaise(int32 Slot) {
+	LowerFor(Slot, LowerDuration + HoldTime);
+}
+
+void UMazeWallAnimator::LowerFor(int32 Slot, float LoweredTime) {
+	if (Actors.IsValidIndex(Slot)) {
+		Lower(Slot);
+		Schedule(Slot, false, LoweredTime);
+	}
+}
+
+void UMazeWallAnimator::RaiseFor(int32 Slot, float RaisedTime, bool bDeadly) {
+	if (Actors.IsValidIndex(Slot)) {
+		Generations[Slot]++;
+		Schedule(Slot, false, 0.f, bDeadly);
+		Schedule(Slot, true, RaisedTime);
+	}
+}
+
+bool UMazeWallAnimator::IsLowered(int32 Slot) const {
+	return Actors.IsValidIndex(Slot) && ToZ[Slot] == LoweredZ[Slot];
+}
+
+void UMazeWallAnimator::Schedule(int32 Slot, bool bLower, float Delay, bool bDeadly) {
+	if (Delay <= 0.f) {
+		StartMove(Slot, bLower, bDeadly);
+		return;
+	}
+	FWallTimer Timer;
+	Timer.Slot = Slot;
+	Timer.Generation = Generations[Slot];
+	Timer.bLower = bLower;
+	Timer.bDeadly = bDeadly;
+	Timers.Schedule(Delay, Timer);
+	SetComponentTickEnabled(true);
+}
+
+void UMazeWallAnimator::StartMove(int32 Slot, bool bLower, bool bDeadly) {
+	const float TargetZ = bLower ? LoweredZ[Slot] : RaisedZ[Slot];
+	const float FullDistance = FMath::Abs(RaisedZ[Slot] - LoweredZ[Slot]);
+	// A wall turned around part way covers the rest of the distance at the usual pace.
+	const float Fraction = FullDistance > 0.f ? FMath::Abs(TargetZ - CurrentZ[Slot]) / FullDistance : 0.f;
+
+	FromZ[Slot] = CurrentZ[Slot];
+	ToZ[Slot] = TargetZ;
+	StartTime[Slot] = Clock;
+	Duration[Slot] = (bLower ? LowerDuration : RaiseDuration) * Fraction;
+	Curves[Slot] = bLower ? LowerCurve : RaiseCurve;
+
+	if (Actors[Slot]) {
+		Actors[Slot]->OnWallMoveStarted(!bLower, Duration[Slot], bDeadly);
+	}
+
+	if (ActiveIndex[Slot] == INDEX_NONE) {
+		ActiveIndex[Slot] = ActiveSlots.Add(Slot);
+	}
+	SetComponentTickEnabled(true);
+}
+
+void UMazeWallAnimator::WriteHeight(int32 Slot, float Z) {
+	if (AMazeWall* Actor = Actors[Slot]) {
+		FVector Location = Actor->GetActorLocation();
+		Location.Z = Z;
+		Actor->SetActorLocation(Location);
+	} else if (WallInstances && Instances[Slot] != INDEX_NONE) {
+		WallInstances->SetWallZ(Instances[Slot], Z);
+	}
+}
+
+float UMazeWallAnimator::EvaluateCurve(EMazeWallCurve Curve, float Alpha) {
+	switch (Curve) {
+	case EMazeWallCurve::WC_Sine:
+		return 0.5f - 0.5f * FMath::Cos(PI * Alpha);
+	case EMazeWallCurve::WC_RisingSine:
+		return FMath::Sin(0.5f * PI * Alpha);
+	default:
+		return Alpha;
+	}
+}
+
+void UMazeWallAnimator::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) {
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	Clock += DeltaTime;
+	Timers.Advance(DeltaTime, [this](const FWallTimer& Timer) {
+		if (Generations.IsValidIndex(Timer.Slot) && Generations[Timer.Slot] == Timer.Generation) {
+			StartMove(Timer.Slot, Timer.bLower, Timer.bDeadly);
+		}
+	});
+
+	int32 Index = 0;
+	while (Index < ActiveSlots.Num()) {
+		const int32 Slot = ActiveSlots[Index];
+		const float Alpha = Duration[Slot] > 0.f ? FMath::Min((Clock - StartTime[Slot]) / Duration[Slot], 1.f) : 1.f;
+		CurrentZ[Slot] = FMath::Lerp(FromZ[Slot], ToZ[Slot], EvaluateCurve(Curves[Slot], Alpha));
+		WriteHeight(Slot, CurrentZ[Slot]);
+
+		if (Alpha >= 1.f) {
+			ActiveIndex[Slot] = INDEX_NONE;
+			ActiveSlots.RemoveAtSwap(Index, 1, false);
+			if (Index < ActiveSlots.Num()) {
+				ActiveIndex[ActiveSlots[Index]] = Index;
+			}
+		} else {
+			Index++;
+		}
+	}
+
+	if (ActiveSlots.Num() == 0 && Timers.Num() == 0) {
+		SetComponentTickEnabled(false);
+	}
+}
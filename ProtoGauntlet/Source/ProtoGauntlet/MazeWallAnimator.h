@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "MyActor.h"
+#include "MazeTimerWheel.h"
+#include "MazeWallAnimator.generated.h"
+
+class UMazeWallInstances;
+
+/**
+ * Raises and lowers a segment's walls natively. Each wall is a slot whose animation state
+ * lives in parallel arrays; one loop per frame moves every wall in flight, whether it is
+ * an actor or an instance, and delayed moves wait on a timer wheel instead of per-wall timers.
+ * The component ticks only while something is moving or pending.
+ */
+UCLASS(ClassGroup = (Maze))
+class PROTOGAUNTLET_API UMazeWallAnimator : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMazeWallAnimator();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Raise and Lower")
+	float RaiseDuration;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Raise and Lower")
+	float LowerDuration;
+
+	/** Time spent at the top of a raise and lower, or at the bottom of a lower and raise. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Raise and Lower")
+	float HoldTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Raise and Lower")
+	EMazeWallCurve RaiseCurve;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Raise and Lower")
+	EMazeWallCurve LowerCurve;
+
+	/** Granularity of delayed moves, in seconds. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Raise and Lower", meta = (ClampMin = "0.001"))
+	float TimerResolution;
+
+	/** Drops every wall and pending move, and sizes the tile lookup. Instanced walls are moved through InWallInstances. */
+	void Reset(int32 NumTiles, UMazeWallInstances* InWallInstances);
+
+	/**
+	 * Adds a wall driven by this component, either Actor or Instance, and returns its slot.
+	 * Heights are world Z for actors and component Z for instances.
+	 */
+	int32 AddWall(AMazeWall* Actor, int32 Instance, float RaisedZ, float LoweredZ, bool bStartLowered);
+
+	/** Points a tile at a slot. A wall covering several tiles maps each of them. */
+	void MapTile(int32 TileIndex, int32 Slot);
+
+	FORCEINLINE int32 GetSlotForTile(int32 TileIndex) const
+	{
+		return TileToSlot.IsValidIndex(TileIndex) ? TileToSlot[TileIndex] : INDEX_NONE;
+	}
+
+	/** Lowers the wall after Delay seconds. Cancels any move still waiting on the timer wheel. */
+	void Lower(int32 Slot, float Delay = 0.f);
+
+	/** Raises the wall after Delay seconds. Cancels any move still waiting on the timer wheel. */
+	void Raise(int32 Slot, float Delay = 0.f);
+
+	/** Raises, holds and lowers again. bDeadly is passed to the actor's OnWallMoveStarted for the rise. */
+	void RaiseAndLower(int32 Slot, bool bDeadly = false);
+
+	void LowerAndRaise(int32 Slot);
+
+	/** Lowers now and raises again after LoweredTime. */
+	void LowerFor(int32 Slot, float LoweredTime);
+
+	/** Raises now and lowers again after RaisedTime. */
+	void RaiseFor(int32 Slot, float RaisedTime, bool bDeadly = false);
+
+	/** The wall actor in a slot, or null for an instance. */
+	FORCEINLINE AMazeWall* GetActor(int32 Slot) const
+	{
+		return Actors.IsValidIndex(Slot) ? Actors[Slot] : nullptr;
+	}
+
+	/** True while the wall is down or heading down. */
+	bool IsLowered(int32 Slot) const;
+
+	FORCEINLINE int32 GetNumAnimating() const
+	{
+		return ActiveSlots.Num();
+	}
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	struct FWallTimer
+	{
+		int32 Slot;
+
+		uint32 Generation;
+
+		bool bLower;
+
+		bool bDeadly;
+	};
+
+	UPROPERTY()
+	UMazeWallInstances* WallInstances;
+
+	TArray<int32> TileToSlot;
+
+	// One entry per slot.
+	TArray<AMazeWall*> Actors;
+
+	TArray<int32> Instances;
+
+	TArray<float> RaisedZ;
+
+	TArray<float> LoweredZ;
+
+	TArray<float> CurrentZ;
+
+	TArray<float> FromZ;
+
+	TArray<float> ToZ;
+
+	TArray<float> StartTime;
+
+	TArray<float> Duration;
+
+	TArray<EMazeWallCurve> Curves;
+
+	/** Bumped by every direct command so stale timers can tell they were overridden. */
+	TArray<uint32> Generations;
+
+	/** Position in ActiveSlots, or INDEX_NONE while still. */
+	TArray<int32> ActiveIndex;
+
+	TArray<int32> ActiveSlots;
+
+	TMazeTimerWheel<FWallTimer> Timers;
+
+	/** Seconds this component has ticked; animation start times are on this clock. */
+	float Clock;
+
+	void Schedule(int32 Slot, bool bLower, float Delay, bool bDeadly = false);
+
+	void StartMove(int32 Slot, bool bLower, bool bDeadly = false);
+
+	void WriteHeight(int32 Slot, float Z);
+
+	static float EvaluateCurve(EMazeWallCurve Curve, float Alpha);
+};
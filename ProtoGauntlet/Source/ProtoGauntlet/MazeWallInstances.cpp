@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeWallInstances.h"
+
+UMazeWallInstances::UMazeWallInstances()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UMazeWallInstances::ResetWalls() {
+	ClearInstances();
+}
+
+int32 UMazeWallInstances::AddWall(const FVector& Location, const FVector& Scale) {
+	return AddInstance(FTransform(FRotator::ZeroRotator, Location, Scale));
+}
+
+void UMazeWallInstances::SetWallZ(int32 Instance, float Z) {
+	FTransform InstanceTransform;
+	if (GetInstanceTransform(Instance, InstanceTransform)) {
+		FVector Location = InstanceTransform.GetLocation();
+		Location.Z = Z;
+		InstanceTransform.SetLocation(Location);
+		UpdateInstanceTransform(Instance, InstanceTransform);
+	}
+}
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "MazeWallInstances.generated.h"
+
+/**
+ * Draws every wall of a segment as one instanced mesh. A wall is identified by its instance
+ * index. The segment's UMazeWallAnimator moves instances up and down through SetWallZ.
+ */
+UCLASS(ClassGroup = (Maze), meta = (BlueprintSpawnableComponent))
+class PROTOGAUNTLET_API UMazeWallInstances : public UInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMazeWallInstances();
+
+	/** Drops every wall. */
+	void ResetWalls();
+
+	/** Adds a wall at Location, relative to the component, and returns its instance index. */
+	int32 AddWall(const FVector& Location, const FVector& Scale);
+
+	/** Moves a wall vertically, keeping the rest of its transform. */
+	void SetWallZ(int32 Instance, float Z);
+};
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeWallMerge.h"
+
+void FMazeWallMerge::Build(const FMazeTileGrid& Grid, TArray<FMazeWallRect>& Rects, TArray<int32>& TileToRect) {
+	Rects.Reset();
+	TileToRect.Init(INDEX_NONE, Grid.Num());
+
+	const ETileDesignation* Tiles = Grid.Tiles.GetData();
+	int32* Covered = TileToRect.GetData();
+	for (int32 y = 0; y < Grid.Height; y++) {
+		for (int32 x = 0; x < Grid.Width; x++) {
+			const int32 Start = Grid.Index(y, x);
+			if (Tiles[Start] != ETileDesignation::TD_Wall || Covered[Start] != INDEX_NONE) {
+				continue;
+			}
+
+			// Tiles left of x on this row are already covered, so the run only meets
+			// covered tiles where a rectangle from an earlier row reaches down into it.
+			int32 Columns = 1;
+			while (x + Columns < Grid.Width && Tiles[Start + Columns] == ETileDesignation::TD_Wall && Covered[Start + Columns] == INDEX_NONE) {
+				Columns++;
+			}
+
+			int32 Rows = 1;
+			for (; y + Rows < Grid.Height; Rows++) {
+				const int32 RowStart = Start + Rows * Grid.Width;
+				int32 Column = 0;
+				while (Column < Columns && Tiles[RowStart + Column] == ETileDesignation::TD_Wall && Covered[RowStart + Column] == INDEX_NONE) {
+					Column++;
+				}
+				if (Column < Columns) {
+					break;
+				}
+			}
+
+			const int32 RectIndex = Rects.Emplace(y, x, Rows, Columns);
+			for (int32 Row = 0; Row < Rows; Row++) {
+				int32* RowCovered = Covered + Start + Row * Grid.Width;
+				for (int32 Column = 0; Column < Columns; Column++) {
+					RowCovered[Column] = RectIndex;
+				}
+			}
+		}
+	}
+}
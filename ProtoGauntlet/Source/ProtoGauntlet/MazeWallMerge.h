@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "MazeTileGrid.h"
+
+/** A block of wall tiles drawn as one piece. */
+struct FMazeWallRect
+{
+	int32 TileRow;
+
+	int32 TileColumn;
+
+	int32 Rows;
+
+	int32 Columns;
+
+	FMazeWallRect(int32 InTileRow, int32 InTileColumn, int32 InRows, int32 InColumns)
+		: TileRow(InTileRow)
+		, TileColumn(InTileColumn)
+		, Rows(InRows)
+		, Columns(InColumns)
+	{
+	}
+};
+
+/**
+ * Greedy meshing of a layout's wall tiles. Scanning row-major, each uncovered wall tile
+ * starts a rectangle that grows right as far as the run goes, then down while every tile
+ * under it is an uncovered wall. Every wall tile ends up in exactly one rectangle.
+ */
+struct FMazeWallMerge
+{
+	/** Fills Rects with the merged walls and TileToRect with each tile's rectangle, or INDEX_NONE for open tiles. */
+	static void Build(const FMazeTileGrid& Grid, TArray<FMazeWallRect>& Rects, TArray<int32>& TileToRect);
+};
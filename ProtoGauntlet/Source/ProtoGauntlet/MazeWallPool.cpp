@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeWallPool.h"
+
+AMazeWallPool::AMazeWallPool()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	PrewarmCount = 1024;
+	HighWaterMark = 0;
+	Misses = 0;
+}
+
+void AMazeWallPool::BeginPlay() {
+	Super::BeginPlay();
+
+	Prewarm(PrewarmCount);
+}
+
+AMazeWallPool* AMazeWallPool::Find(UWorld* World) {
+	if (World) {
+		for (TActorIterator<AMazeWallPool> It(World); It; ++It) {
+			return *It;
+		}
+	}
+	return nullptr;
+}
+
+void AMazeWallPool::Prewarm(int32 Count) {
+	if (!WallClass) {
+		return;
+	}
+	FreeWalls.Reserve(Count);
+	while (FreeWalls.Num() < Count) {
+		AMazeWall* Wall = SpawnIdleWall();
+		if (!Wall) {
+			break;
+		}
+		FreeWalls.Add(Wall);
+	}
+}
+
+AMazeWall* AMazeWallPool::SpawnIdleWall() {
+	AMazeWall* Wall = Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass, &GetActorTransform()));
+	if (Wall) {
+		Wall->SetActorHiddenInGame(true);
+		Wall->SetActorEnableCollision(false);
+	}
+	return Wall;
+}
+
+AMazeWall* AMazeWallPool::AcquireWall(TSubclassOf<AMazeWall> Class) {
+	AMazeWall* Wall = nullptr;
+	if (Class == WallClass) {
+		while (!Wall && FreeWalls.Num() > 0) {
+			Wall = FreeWalls.Pop(false);
+			if (Wall && Wall->IsPendingKill()) {
+				Wall = nullptr;
+			}
+		}
+	}
+
+	if (!Wall) {
+		Misses++;
+		Wall = Cast<AMazeWall>(GetWorld()->SpawnActor(Class));
+		if (!Wall) {
+			return nullptr;
+		}
+	}
+
+	Wall->SetActorHiddenInGame(false);
+	Wall->SetActorEnableCollision(true);
+	Wall->LowerEnabled = true;
+	Wall->RaiseEnabled = true;
+	if (Class == WallClass) {
+		ActiveWalls.Add(Wall);
+		HighWaterMark = FMath::Max(HighWaterMark, ActiveWalls.Num());
+	}
+	return Wall;
+}
+
+bool AMazeWallPool::ReleaseWall(AMazeWall* Wall) {
+	if (!Wall || ActiveWalls.Remove(Wall) == 0) {
+		return false;
+	}
+	// A wall released mid-move must not finish it, or flip its flags, under its next owner.
+	GetWorldTimerManager().ClearAllTimersForObject(Wall);
+	GetWorld()->GetLatentActionManager().RemoveActionsForObject(Wall);
+	Wall->ResetForPool();
+	Wall->SetActorHiddenInGame(true);
+	Wall->SetActorEnableCollision(false);
+	Wall->SetActorTransform(GetActorTransform());
+	FreeWalls.Add(Wall);
+	return true;
+}
+
+void AMazeWallPool::GetPoolStats(int32 & Free, int32 & InUse, int32 & PeakInUse, int32 & SpawnMisses) {
+	Free = FreeWalls.Num();
+	InUse = ActiveWalls.Num();
+	PeakInUse = HighWaterMark;
+	SpawnMisses = Misses;
+}
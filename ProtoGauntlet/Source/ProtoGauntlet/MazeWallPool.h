@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "MazeWall.h"
+#include "MazeWallPool.generated.h"
+
+/**
+ * World-wide store of idle AMazeWall actors. Segments acquire walls from it instead of
+ * spawning and hand them back when they are torn down, so a rebuild reuses actors.
+ * Place one in the level; segments find it at BeginPlay and spawn directly without one.
+ */
+UCLASS()
+class PROTOGAUNTLET_API AMazeWallPool : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AMazeWallPool();
+
+	/** Class kept in the pool. Requests for any other class are spawned directly and counted as misses. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Pool")
+	TSubclassOf<AMazeWall> WallClass;
+
+	/** Walls spawned at BeginPlay, before any segment asks for one. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Pool", meta = (ClampMin = "0"))
+	int32 PrewarmCount;
+
+	/** First pool in World, or null. */
+	static AMazeWallPool* Find(UWorld* World);
+
+	/** A visible, colliding wall of Class with its raise and lower flags reset. The caller places it. */
+	AMazeWall* AcquireWall(TSubclassOf<AMazeWall> Class);
+
+	/**
+	 * Stops Wall's timers, delays and timelines, hides it and keeps it for reuse. Returns
+	 * false, leaving Wall alone, if the pool did not hand it out.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Wall Pool")
+	bool ReleaseWall(AMazeWall* Wall);
+
+	/** Spawns idle walls until Count are free. */
+	UFUNCTION(BlueprintCallable, Category = "Wall Pool")
+	void Prewarm(int32 Count);
+
+	/** PeakInUse is the most walls out at once; SpawnMisses counts walls that had to be spawned on demand. */
+	UFUNCTION(BlueprintCallable, Category = "Wall Pool")
+	void GetPoolStats(int32 & Free, int32 & InUse, int32 & PeakInUse, int32 & SpawnMisses);
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	UPROPERTY()
+	TArray<AMazeWall*> FreeWalls;
+
+	/** Walls handed out and not yet returned. They stay referenced by the level while in use. */
+	TSet<AMazeWall*> ActiveWalls;
+
+	int32 HighWaterMark;
+
+	int32 Misses;
+
+	AMazeWall* SpawnIdleWall();
+};
@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProtoGauntlet.h"
+#include "MazeWallSequencer.h"
+#include "MazeWall.h"
+
+UMazeWallSequencer::UMazeWallSequencer()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	TimeScale = 1.f;
+	bReenableWalls = false;
+	Cursor = 0;
+	PlaybackTime = 0.f;
+	bPlaying = false;
+	bSorted = true;
+	TimelineVersion = 0;
+}
+
+void UMazeWallSequencer::ResetTimeline() {
+	ClearEvents();
+	SetWalls.Reset();
+	WallSets.Reset();
+}
+
+void UMazeWallSequencer::ClearEvents() {
+	Stop();
+	Events.Reset();
+	TimelineVersion++;
+	Cursor = 0;
+	PlaybackTime = 0.f;
+	bSorted = true;
+}
+
+int32 UMazeWallSequencer::AddWallSet(const TArray<AMazeWall*>& Walls) {
+	FWallSpan Span;
+	Span.Start = SetWalls.Num();
+	Span.Num = Walls.Num();
+	SetWalls.Append(Walls);
+	return WallSets.Add(Span);
+}
+
+void UMazeWallSequencer::AddEvent(float Time, int32 WallSet, EMazeWallAction Action, int32 Marker) {
+	if (Action != EMazeWallAction::WA_Marker && !WallSets.IsValidIndex(WallSet)) {
+		return;
+	}
+	FMazeWallSequenceEvent Event;
+	Event.Time = Time;
+	Event.WallSet = WallSet;
+	Event.Action = Action;
+	Event.Marker = Marker;
+	bSorted = bSorted && (Events.Num() == 0 || Events.Last().Time <= Time);
+	Events.Add(Event);
+}
+
+void UMazeWallSequencer::SortEvents() {
+	if (!bSorted) {
+		// Stable, so events at the same time keep the order they were added in.
+		Events.StableSort([](const FMazeWallSequenceEvent& A, const FMazeWallSequenceEvent& B) {
+			return A.Time < B.Time;
+		});
+		bSorted = true;
+	}
+}
+
+int32 UMazeWallSequencer::FindCursor(float Time) const {
+	int32 Low = 0;
+	int32 High = Events.Num();
+	while (Low < High) {
+		const int32 Middle = (Low + High) / 2;
+		if (Events[Middle].Time <= Time) {
+			Low = Middle + 1;
+		} else {
+			High = Middle;
+		}
+	}
+	return Low;
+}
+
+void UMazeWallSequencer::Play(float StartTime) {
+	SortEvents();
+	TimelineVersion++;
+	PlaybackTime = StartTime;
+	Cursor = FindCursor(StartTime - KINDA_SMALL_NUMBER);
+	bPlaying = Cursor < Events.Num();
+	SetComponentTickEnabled(bPlaying);
+}
+
+void UMazeWallSequencer::Stop() {
+	bPlaying = false;
+	SetComponentTickEnabled(false);
+}
+
+void UMazeWallSequencer::SeekTo(float Time) {
+	SortEvents();
+	const int32 NewCursor = FindCursor(Time);
+
+	// Replay only the final state: the last action per wall set and the last marker.
+	TArray<int32> LastEventForSet;
+	LastEventForSet.Init(INDEX_NONE, WallSets.Num());
+	int32 LastMarker = INDEX_NONE;
+	for (int32 EventIndex = 0; EventIndex < NewCursor; EventIndex++) {
+		if (Events[EventIndex].Action == EMazeWallAction::WA_Marker) {
+			LastMarker = EventIndex;
+		} else {
+			LastEventForSet[Events[EventIndex].WallSet] = EventIndex;
+		}
+	}
+	for (int32 WallSet = 0; WallSet < WallSets.Num(); WallSet++) {
+		if (LastEventForSet[WallSet] != INDEX_NONE) {
+			DispatchNow(WallSet, Events[LastEventForSet[WallSet]].Action);
+		}
+	}
+	if (LastMarker != INDEX_NONE && OnMarker) {
+		OnMarker(Events[LastMarker].Marker);
+	}
+
+	TimelineVersion++;
+	Cursor = NewCursor;
+	PlaybackTime = Time;
+	bPlaying = Cursor < Events.Num();
+	SetComponentTickEnabled(bPlaying);
+}
+
+float UMazeWallSequencer::GetPlaybackTime() {
+	return PlaybackTime;
+}
+
+float UMazeWallSequencer::GetDuration() {
+	SortEvents();
+	return Events.Num() > 0 ? Events.Last().Time : 0.f;
+}
+
+bool UMazeWallSequencer::IsPlaying() {
+	return bPlaying;
+}
+
+void UMazeWallSequencer::DispatchNow(int32 WallSet, EMazeWallAction Action) {
+	if (Action == EMazeWallAction::WA_Marker || !WallSets.IsValidIndex(WallSet)) {
+		return;
+	}
+	const FWallSpan& Span = WallSets[WallSet];
+	for (int32 WallIndex = Span.Start; WallIndex < Span.Start + Span.Num; WallIndex++) {
+		AMazeWall* Wall = SetWalls[WallIndex];
+		if (!Wall) {
+			continue;
+		}
+		if (Action == EMazeWallAction::WA_Lower) {
+			Wall->Lower();
+			Wall->LowerEnabled = Wall->LowerEnabled || bReenableWalls;
+		} else {
+			Wall->Raise();
+			Wall->RaiseEnabled = Wall->RaiseEnabled || bReenableWalls;
+		}
+	}
+}
+
+void UMazeWallSequencer::DispatchEvents(int32 First, int32 Last) {
+	const int32 Version = TimelineVersion;
+	for (int32 EventIndex = First; EventIndex < Last && TimelineVersion == Version; EventIndex++) {
+		// Copied, since a marker handler may rebuild the timeline.
+		const FMazeWallSequenceEvent Event = Events[EventIndex];
+		if (Event.Action == EMazeWallAction::WA_Marker) {
+			if (OnMarker) {
+				OnMarker(Event.Marker);
+			}
+		} else {
+			DispatchNow(Event.WallSet, Event.Action);
+		}
+	}
+}
+
+void UMazeWallSequencer::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) {
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bPlaying) {
+		return;
+	}
+	PlaybackTime += DeltaTime * TimeScale;
+
+	const int32 First = Cursor;
+	while (Cursor < Events.Num() && Events[Cursor].Time <= PlaybackTime) {
+		Cursor++;
+	}
+	// The cursor moves first, so a marker handler may stop, seek or rebuild the timeline.
+	const int32 Last = Cursor;
+	DispatchEvents(First, Last);
+
+	if (bPlaying && Cursor >= Events.Num()) {
+		Stop();
+	}
+}
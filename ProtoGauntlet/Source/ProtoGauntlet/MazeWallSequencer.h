@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "MyActor.h"
+#include "MazeWallSequencer.generated.h"
+
+/** One timeline entry: at Time, apply Action to every wall in WallSet, or report Marker. */
+struct FMazeWallSequenceEvent
+{
+	float Time;
+
+	int32 WallSet;
+
+	EMazeWallAction Action;
+
+	int32 Marker;
+};
+
+/**
+ * Plays a compiled timeline of wall choreography. Wall sets are spans of one flat wall array
+ * and events are kept sorted by time, so playback is a single cursor: each tick dispatches
+ * every event that came due in one pass. Playback can be scaled and scrubbed for testing.
+ */
+UCLASS(ClassGroup = (Maze))
+class PROTOGAUNTLET_API UMazeWallSequencer : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMazeWallSequencer();
+
+	/** Playback speed; 2 runs the timeline twice as fast. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wall Sequence", meta = (ClampMin = "0.0"))
+	float TimeScale;
+
+	/** Set LowerEnabled or RaiseEnabled back to true after each lower or raise, for walls whose Blueprint locks them while moving. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wall Sequence")
+	bool bReenableWalls;
+
+	/** Called with an event's Marker when a marker event is dispatched or scrubbed past. */
+	TFunction<void(int32)> OnMarker;
+
+	/** Stops playback and drops every event and wall set. */
+	void ResetTimeline();
+
+	/** Stops playback and drops the events, keeping the wall sets. */
+	void ClearEvents();
+
+	/** Stores a set of walls and returns its index for AddEvent. */
+	int32 AddWallSet(const TArray<AMazeWall*>& Walls);
+
+	/** Queues an event. Events may be added in any order; Play sorts them. Wall actions on an unknown set are dropped. */
+	void AddEvent(float Time, int32 WallSet, EMazeWallAction Action, int32 Marker = 0);
+
+	/** Sorts the timeline and plays it from StartTime, dispatching nothing before it. */
+	void Play(float StartTime = 0.f);
+
+	UFUNCTION(BlueprintCallable, Category = "Wall Sequence")
+	void Stop();
+
+	/**
+	 * Jumps to Time. Each wall set gets the last action due by then and the last marker due
+	 * is reported, so the segment ends up as if it had played there.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Wall Sequence")
+	void SeekTo(float Time);
+
+	UFUNCTION(BlueprintCallable, Category = "Wall Sequence")
+	float GetPlaybackTime();
+
+	/** Time of the last event, or zero for an empty timeline. */
+	UFUNCTION(BlueprintCallable, Category = "Wall Sequence")
+	float GetDuration();
+
+	UFUNCTION(BlueprintCallable, Category = "Wall Sequence")
+	bool IsPlaying();
+
+	/** Applies an action to a wall set now, outside the timeline. */
+	void DispatchNow(int32 WallSet, EMazeWallAction Action);
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	struct FWallSpan
+	{
+		int32 Start;
+
+		int32 Num;
+	};
+
+	UPROPERTY()
+	TArray<AMazeWall*> SetWalls;
+
+	TArray<FWallSpan> WallSets;
+
+	TArray<FMazeWallSequenceEvent> Events;
+
+	/** First event not yet dispatched. */
+	int32 Cursor;
+
+	float PlaybackTime;
+
+	bool bPlaying;
+
+	bool bSorted;
+
+	/** Bumped whenever the events are cleared or the cursor jumps, so a dispatch in progress can tell. */
+	int32 TimelineVersion;
+
+	void SortEvents();
+
+	/** Index of the first event due after Time. */
+	int32 FindCursor(float Time) const;
+
+	void DispatchEvents(int32 First, int32 Last);
+};
@@ -4,12 +4,22 @@
 #include "MegaMaze.h"
 #include "MazeSegment.h"
 
+namespace
+{
+	/** Steps from a segment's edge tile, through the two border gap tiles, onto the neighbor's edge tile. */
+	const int32 BorderCrossingCost = 3;
+
+	FORCEINLINE uint8 OppositeSide(uint8 Side)
+	{
+		return (Side + 2) % 4;
+	}
+}
 
 // Sets default values
 AMegaMaze::AMegaMaze()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	PrimaryActorTick.bCanEverTick = true;
 
 	WidthInMazeSegments = 3;
 	HeightInMazeSegments = 3;
@@ -18,6 +28,15 @@ AMegaMaze::AMegaMaze()
 	FloorHeight = 100.f;
 	InnerWallHeight = 600.f;
 	OuterWallHeight = 800.f;
+	RandomSeed = 0;
+	SegmentsFinalizedPerTick = 1;
+	BuildStage = EMegaMazeBuildStage::MBS_NotStarted;
+	SegmentsFinalized = 0;
+	bStreamSegmentWalls = false;
+	StreamInRadius = 8000.f;
+	StreamOutRadius = 12000.f;
+	StreamingUpdateInterval = 0.25f;
+	SegmentsMaterializedPerUpdate = 2;
 }
 
 // Called when the game starts or when spawned
@@ -28,6 +47,10 @@ void AMegaMaze::BeginPlay()
 	AMazeSegment* CurrentSegment;
 	FVector SegmentLocation;
 	UWorld* const World = GetWorld();
+	Segments.Reset();
+	if (RandomSeed == 0) {
+		RandomSeed = FMazeRandomStream::DeriveSeed(FMath::Rand(), FMath::Rand());
+	}
 	if (World != NULL)
 	{
 		for (int32 y = 0; y < HeightInMazeSegments; y++)
@@ -35,9 +58,16 @@ void AMegaMaze::BeginPlay()
 			for (int32 x = 0; x < WidthInMazeSegments; x++)
 			{
 				SegmentLocation = GetActorLocation() + FVector((float)((MazeLengthInTiles + 2) * x) * TileSize, (float)((MazeLengthInTiles + 2) * y) * TileSize, 0.f);
-				CurrentSegment = World->SpawnActor<AMazeSegment>(MazeSegmentClass);
-				CurrentSegment->SetActorLocation(SegmentLocation, false);
+				// Deferred: the layout is built from the final parameters before the segment's BeginPlay.
+				CurrentSegment = World->SpawnActorDeferred<AMazeSegment>(MazeSegmentClass, SegmentLocation, FRotator::ZeroRotator);
 				CurrentSegment->ChangeMazeParameters(MazeLengthInTiles, TileSize, FloorHeight, InnerWallHeight, OuterWallHeight);
+				CurrentSegment->SetWallStreaming(bStreamSegmentWalls);
+				CurrentSegment->SetRandomSeed(FMazeRandomStream::DeriveSeed(RandomSeed, y * WidthInMazeSegments + x));
+				// Neighbours share a border: the west and north segment spawns it two tiles thick.
+				CurrentSegment->SetSharedBorders(
+					(x > 0 ? 1 << (uint8)EDirection::D_West : 0) | (y > 0 ? 1 << (uint8)EDirection::D_North : 0),
+					(x < WidthInMazeSegments - 1 ? 1 << (uint8)EDirection::D_East : 0) | (y < HeightInMazeSegments - 1 ? 1 << (uint8)EDirection::D_South : 0));
+				Segments.Add(CurrentSegment);
 				if (WidthInMazeSegments / 2 == x && HeightInMazeSegments / 2 == y)
 				{
 					//(*CurrentSegment).IsCenterPiece = true;
@@ -46,6 +76,68 @@ void AMegaMaze::BeginPlay()
 			}
 		}
 	}
+	SegmentPortals.Reset();
+	SegmentPortals.SetNum(Segments.Num());
+
+	// Each task builds into a grid of its own, never a segment's reflected Grid, which the GC
+	// may walk while the tasks run. Segments take their grids over in FinalizeSegment.
+	LayoutsBuilt.Reset();
+	SegmentsFinalized = 0;
+	LayoutTasks.Reset();
+	PendingLayouts.Reset();
+	PendingLayouts.SetNum(Segments.Num());
+	for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); SegmentIndex++) {
+		AMazeSegment* Segment = Segments[SegmentIndex];
+		FMazeTileGrid* Layout = &PendingLayouts[SegmentIndex];
+		LayoutTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this, Segment, Layout]() {
+			Segment->BuildLayoutInto(*Layout);
+			LayoutsBuilt.Increment();
+		}, TStatId(), nullptr, ENamedThreads::AnyThread));
+	}
+	BuildStage = EMegaMazeBuildStage::MBS_GeneratingLayouts;
+}
+
+void AMegaMaze::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	GetWorldTimerManager().ClearTimer(StreamingTimer);
+	if (LayoutTasks.Num() != 0) {
+		FTaskGraphInterface::Get().WaitUntilTasksComplete(LayoutTasks, ENamedThreads::GameThread);
+		LayoutTasks.Reset();
+	}
+
+	// Segments past SegmentsFinalized were spawned deferred and never finished, so nothing else will tear them down.
+	if (BuildStage == EMegaMazeBuildStage::MBS_GeneratingLayouts || BuildStage == EMegaMazeBuildStage::MBS_Finalizing) {
+		for (int32 SegmentIndex = SegmentsFinalized; SegmentIndex < Segments.Num(); SegmentIndex++) {
+			if (Segments[SegmentIndex]) {
+				Segments[SegmentIndex]->Destroy();
+			}
+		}
+		Segments.SetNum(SegmentsFinalized);
+		PendingLayouts.Empty();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+EMegaMazeBuildStage AMegaMaze::GetBuildStage() {
+	return BuildStage;
+}
+
+float AMegaMaze::GetBuildProgress() {
+	if (BuildStage == EMegaMazeBuildStage::MBS_Complete) {
+		return 1.f;
+	} else if (Segments.Num() == 0) {
+		return 0.f;
+	}
+	return (float)(LayoutsBuilt.GetValue() + SegmentsFinalized) / (float)(Segments.Num() * 2);
+}
+
+void AMegaMaze::FinalizeSegment(int32 SegmentIndex) {
+	AMazeSegment* Segment = Segments[SegmentIndex];
+	const int32 SegmentX = SegmentIndex % WidthInMazeSegments;
+	const int32 SegmentY = SegmentIndex / WidthInMazeSegments;
+	const FVector SegmentLocation = GetActorLocation() + FVector((float)((MazeLengthInTiles + 2) * SegmentX) * TileSize, (float)((MazeLengthInTiles + 2) * SegmentY) * TileSize, 0.f);
+	Segment->AdoptLayout(PendingLayouts[SegmentIndex]);
+	Segment->FinishSpawning(FTransform(SegmentLocation));
 }
 
 void AMegaMaze::CalculateValues()
@@ -69,6 +161,29 @@ void AMegaMaze::Tick( float DeltaTime )
 {
 	Super::Tick( DeltaTime );
 
+	if (BuildStage == EMegaMazeBuildStage::MBS_GeneratingLayouts && LayoutsBuilt.GetValue() == Segments.Num()) {
+		LayoutTasks.Reset();
+		BuildStage = EMegaMazeBuildStage::MBS_Finalizing;
+	}
+
+	// Spawning walls is game thread work; spread it over frames so loading keeps drawing.
+	if (BuildStage == EMegaMazeBuildStage::MBS_Finalizing) {
+		for (int32 Count = 0; Count < FMath::Max(SegmentsFinalizedPerTick, 1) && SegmentsFinalized < Segments.Num(); Count++) {
+			FinalizeSegment(SegmentsFinalized++);
+		}
+
+		if (SegmentsFinalized == Segments.Num()) {
+			BuildStage = EMegaMazeBuildStage::MBS_Complete;
+			PendingLayouts.Empty();
+			SetActorTickEnabled(false);
+			if (bStreamSegmentWalls) {
+				GetWorldTimerManager().SetTimer(StreamingTimer, this, &AMegaMaze::UpdateWallStreaming, FMath::Max(StreamingUpdateInterval, 0.01f), true);
+				UpdateWallStreaming();
+			}
+			OnMazeBuilt.Broadcast();
+		}
+	}
+
 }
 
 #if WITH_EDITOR
@@ -80,3 +195,356 @@ void AMegaMaze::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEve
 }
 #endif
 
+void AMegaMaze::AddStreamingSource(AActor* Source) {
+	if (Source) {
+		StreamingSources.AddUnique(Source);
+	}
+}
+
+void AMegaMaze::RemoveStreamingSource(AActor* Source) {
+	StreamingSources.Remove(Source);
+}
+
+int32 AMegaMaze::GetNumMaterializedSegments() {
+	int32 Count = 0;
+	for (AMazeSegment* Segment : Segments) {
+		Count += Segment && Segment->AreWallsMaterialized() ? 1 : 0;
+	}
+	return Count;
+}
+
+float AMegaMaze::GetDistanceToSegment(int32 SegmentIndex, const FVector& Location) const {
+	const float SegmentStride = (float)(MazeLengthInTiles + 2) * TileSize;
+	const FVector RelativeLocation = Location - GetActorLocation();
+	const float MinX = (float)(SegmentIndex % WidthInMazeSegments) * SegmentStride;
+	const float MinY = (float)(SegmentIndex / WidthInMazeSegments) * SegmentStride;
+	const float DeltaX = FMath::Max3(MinX - RelativeLocation.X, RelativeLocation.X - (MinX + SegmentStride), 0.f);
+	const float DeltaY = FMath::Max3(MinY - RelativeLocation.Y, RelativeLocation.Y - (MinY + SegmentStride), 0.f);
+	return FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY);
+}
+
+void AMegaMaze::UpdateWallStreaming() {
+	UWorld* const World = GetWorld();
+	if (!World || BuildStage != EMegaMazeBuildStage::MBS_Complete) {
+		return;
+	}
+
+	TArray<FVector> SourceLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It) {
+		APawn* Pawn = (*It)->GetPawn();
+		if (Pawn) {
+			SourceLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+	for (int32 SourceIndex = StreamingSources.Num() - 1; SourceIndex >= 0; SourceIndex--) {
+		AActor* Source = StreamingSources[SourceIndex].Get();
+		if (Source) {
+			SourceLocations.Add(Source->GetActorLocation());
+		} else {
+			StreamingSources.RemoveAtSwap(SourceIndex);
+		}
+	}
+
+	// Two radii so a source pacing along a segment edge does not respawn its walls every update.
+	const float OutRadius = FMath::Max(StreamOutRadius, StreamInRadius);
+	TArray<TPair<float, int32>> ToMaterialize;
+	for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); SegmentIndex++) {
+		AMazeSegment* Segment = Segments[SegmentIndex];
+		// Segments that cannot respawn their walls faithfully keep them for good.
+		if (!Segment || !Segment->SupportsWallStreaming()) {
+			continue;
+		}
+
+		float Distance = BIG_NUMBER;
+		for (const FVector& Location : SourceLocations) {
+			Distance = FMath::Min(Distance, GetDistanceToSegment(SegmentIndex, Location));
+		}
+
+		if (Segment->AreWallsMaterialized()) {
+			if (Distance > OutRadius) {
+				Segment->DematerializeWalls();
+			}
+		} else if (Distance <= StreamInRadius) {
+			ToMaterialize.Add(TPair<float, int32>(Distance, SegmentIndex));
+		}
+	}
+
+	ToMaterialize.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) {
+		return A.Key < B.Key;
+	});
+	for (int32 Count = 0; Count < FMath::Min(ToMaterialize.Num(), FMath::Max(SegmentsMaterializedPerUpdate, 1)); Count++) {
+		Segments[ToMaterialize[Count].Value]->MaterializeWalls();
+	}
+}
+
+AMazeSegment* AMegaMaze::GetSegmentAtLocation(FVector Location) {
+	FIntPair Tile;
+	const int32 SegmentIndex = FindSegmentTile(Location, Tile);
+	return SegmentIndex != INDEX_NONE ? Segments[SegmentIndex] : nullptr;
+}
+
+int32 AMegaMaze::FindSegmentTile(FVector Location, FIntPair& Tile) {
+	const FVector RelativeLocation = Location - GetActorLocation();
+	const float SegmentStride = (float)(MazeLengthInTiles + 2) * TileSize;
+	const int32 SegmentX = FGenericPlatformMath::FloorToInt(RelativeLocation.X / SegmentStride);
+	const int32 SegmentY = FGenericPlatformMath::FloorToInt(RelativeLocation.Y / SegmentStride);
+	if (SegmentX < 0 || SegmentY < 0 || SegmentX >= WidthInMazeSegments || SegmentY >= HeightInMazeSegments) {
+		return INDEX_NONE;
+	}
+
+	const int32 SegmentIndex = SegmentY * WidthInMazeSegments + SegmentX;
+	if (!Segments.IsValidIndex(SegmentIndex) || !Segments[SegmentIndex]) {
+		return INDEX_NONE;
+	}
+
+	int32 TileRow;
+	int32 TileColumn;
+	Segments[SegmentIndex]->GetTileIndexAtLocation(Location, TileRow, TileColumn);
+	if (!Segments[SegmentIndex]->GetGrid().IsValid(TileRow, TileColumn)) {
+		return INDEX_NONE;
+	}
+	Tile = FIntPair(TileColumn, TileRow);
+	return SegmentIndex;
+}
+
+FIntPair AMegaMaze::GetPortalTile(int32 SegmentIndex, uint8 Side) const {
+	const int32 Length = Segments[SegmentIndex]->GetGrid().Width;
+	const int32 Middle = Length / 2;
+	switch ((EDirection)Side) {
+	case EDirection::D_North: return FIntPair(Middle, 0);
+	case EDirection::D_East: return FIntPair(Length - 1, Middle);
+	case EDirection::D_South: return FIntPair(Middle, Length - 1);
+	default: return FIntPair(0, Middle);
+	}
+}
+
+int32 AMegaMaze::GetNeighborSegment(int32 SegmentIndex, uint8 Side) const {
+	const FIntPair Neighbor = FMazeTileGrid::Step(FIntPair(SegmentIndex % WidthInMazeSegments, SegmentIndex / WidthInMazeSegments), (EDirection)Side);
+	if (Neighbor.x < 0 || Neighbor.y < 0 || Neighbor.x >= WidthInMazeSegments || Neighbor.y >= HeightInMazeSegments) {
+		return INDEX_NONE;
+	}
+
+	const int32 NeighborIndex = Neighbor.y * WidthInMazeSegments + Neighbor.x;
+	return Segments.IsValidIndex(NeighborIndex) && Segments[NeighborIndex] ? NeighborIndex : INDEX_NONE;
+}
+
+FIntPair AMegaMaze::GetGlobalTile(int32 SegmentIndex, FIntPair Tile) const {
+	const int32 Stride = Segments[SegmentIndex]->GetGrid().Width + 2;
+	return FIntPair((SegmentIndex % WidthInMazeSegments) * Stride + Tile.x + 1, (SegmentIndex / WidthInMazeSegments) * Stride + Tile.y + 1);
+}
+
+const FMazeSegmentPortals& AMegaMaze::GetSegmentPortals(int32 SegmentIndex) {
+	AMazeSegment* Segment = Segments[SegmentIndex];
+	FMazeSegmentPortals& Portals = SegmentPortals[SegmentIndex];
+	const int32 LayoutVersion = Segment->GetLayoutVersion();
+	if (Portals.LayoutVersion == LayoutVersion) {
+		return Portals;
+	}
+
+	const FMazeTileGrid& Grid = Segment->GetGrid();
+	FIntPair PortalTiles[4];
+	for (uint8 Side = 0; Side < 4; Side++) {
+		PortalTiles[Side] = GetPortalTile(SegmentIndex, Side);
+		Portals.bOpen[Side] = Grid.IsPath(PortalTiles[Side].y, PortalTiles[Side].x);
+	}
+
+	for (uint8 From = 0; From < 4; From++) {
+		Portals.Costs[From * 4 + From] = Portals.bOpen[From] ? 0 : INDEX_NONE;
+		for (uint8 To = From + 1; To < 4; To++) {
+			int32 Cost = INDEX_NONE;
+			if (Portals.bOpen[From] && Portals.bOpen[To]) {
+				Cost = Segment->GetPathLength(PortalTiles[From], PortalTiles[To]);
+				Cost = Cost < 0 ? INDEX_NONE : Cost;
+			}
+			Portals.Costs[From * 4 + To] = Cost;
+			Portals.Costs[To * 4 + From] = Cost;
+		}
+	}
+	Portals.LayoutVersion = LayoutVersion;
+	return Portals;
+}
+
+bool AMegaMaze::PlanRoute(FVector StartLocation, FVector EndLocation, FMazeMegaRoute & Route) {
+	Route.Legs.Reset();
+	Route.TotalCost = 0;
+
+	FIntPair StartTile;
+	FIntPair EndTile;
+	if (BuildStage != EMegaMazeBuildStage::MBS_Complete) {
+		return false;
+	}
+
+	const int32 StartSegment = FindSegmentTile(StartLocation, StartTile);
+	const int32 EndSegment = FindSegmentTile(EndLocation, EndTile);
+	if (StartSegment == INDEX_NONE || EndSegment == INDEX_NONE) {
+		return false;
+	}
+
+	// Abstract graph: four portal nodes per segment, then the start and end tiles.
+	const int32 StartNode = Segments.Num() * 4;
+	const int32 EndNode = StartNode + 1;
+	const FIntPair EndGlobal = GetGlobalTile(EndSegment, EndTile);
+
+	auto NodeSegment = [&](int32 Node) {
+		return Node == StartNode ? StartSegment : Node == EndNode ? EndSegment : Node / 4;
+	};
+	auto NodeTile = [&](int32 Node) {
+		return Node == StartNode ? StartTile : Node == EndNode ? EndTile : GetPortalTile(Node / 4, Node % 4);
+	};
+	auto Estimate = [&](int32 Node) {
+		const FIntPair Global = GetGlobalTile(NodeSegment(Node), NodeTile(Node));
+		return FMath::Abs(Global.x - EndGlobal.x) + FMath::Abs(Global.y - EndGlobal.y);
+	};
+
+	// Costs from the end segment's portals to the end tile are needed by every expansion that reaches it.
+	int32 EndCosts[4];
+	const FMazeSegmentPortals& EndPortals = GetSegmentPortals(EndSegment);
+	for (uint8 Side = 0; Side < 4; Side++) {
+		EndCosts[Side] = EndPortals.bOpen[Side] ? Segments[EndSegment]->GetPathLength(GetPortalTile(EndSegment, Side), EndTile) : INDEX_NONE;
+	}
+
+	FMazeSearchScratch& Scratch = RouteScratch;
+	TArray<FMazeOpenNode>& Open = Scratch.Open;
+	Scratch.Begin(EndNode + 1);
+
+	auto Relax = [&](int32 Node, int32 Cost, int32 Parent) {
+		if (Scratch.IsVisited(Node) || (Scratch.IsDiscovered(Node) && Scratch.Cost[Node] <= Cost)) {
+			return;
+		}
+		Scratch.Discover(Node, Cost, Parent);
+		Open.HeapPush(FMazeOpenNode(Cost + Estimate(Node), Cost, Node), TLess<FMazeOpenNode>());
+	};
+
+	// Seed with the start tile's own segment: its open portals and, if it is shared, the end tile.
+	Scratch.Discover(StartNode, 0, INDEX_NONE);
+	Scratch.Visit(StartNode);
+	if (StartSegment == EndSegment) {
+		const int32 Direct = Segments[StartSegment]->GetPathLength(StartTile, EndTile);
+		if (Direct >= 0) {
+			Relax(EndNode, Direct, StartNode);
+		}
+	}
+	const FMazeSegmentPortals& StartPortals = GetSegmentPortals(StartSegment);
+	for (uint8 Side = 0; Side < 4; Side++) {
+		if (StartPortals.bOpen[Side]) {
+			const int32 Cost = Segments[StartSegment]->GetPathLength(StartTile, GetPortalTile(StartSegment, Side));
+			if (Cost >= 0) {
+				Relax(StartSegment * 4 + Side, Cost, StartNode);
+			}
+		}
+	}
+
+	FMazeOpenNode Top(0, 0, INDEX_NONE);
+	bool bFound = false;
+	while (Open.Num() != 0) {
+		Open.HeapPop(Top, TLess<FMazeOpenNode>(), false);
+		if (Top.Cost != Scratch.Cost[Top.TileIndex] || Scratch.IsVisited(Top.TileIndex)) {
+			continue;
+		}
+		Scratch.Visit(Top.TileIndex);
+
+		if (Top.TileIndex == EndNode) {
+			bFound = true;
+			break;
+		}
+
+		const int32 SegmentIndex = Top.TileIndex / 4;
+		const uint8 Side = Top.TileIndex % 4;
+
+		// Across the border onto the neighbor's facing portal.
+		const int32 Neighbor = GetNeighborSegment(SegmentIndex, Side);
+		if (Neighbor != INDEX_NONE && GetSegmentPortals(Neighbor).bOpen[OppositeSide(Side)]) {
+			Relax(Neighbor * 4 + OppositeSide(Side), Top.Cost + BorderCrossingCost, Top.TileIndex);
+		}
+
+		// Through the segment to its other portals, or to the end tile.
+		const FMazeSegmentPortals& Portals = GetSegmentPortals(SegmentIndex);
+		for (uint8 To = 0; To < 4; To++) {
+			if (To != Side && Portals.Costs[Side * 4 + To] != INDEX_NONE) {
+				Relax(SegmentIndex * 4 + To, Top.Cost + Portals.Costs[Side * 4 + To], Top.TileIndex);
+			}
+		}
+		if (SegmentIndex == EndSegment && EndCosts[Side] >= 0) {
+			Relax(EndNode, Top.Cost + EndCosts[Side], Top.TileIndex);
+		}
+	}
+
+	if (!bFound) {
+		return false;
+	}
+
+	TArray<int32> Nodes;
+	for (int32 Node = EndNode; Node != INDEX_NONE; Node = Scratch.Parent[Node]) {
+		Nodes.Add(Node);
+	}
+
+	// Walk start to end, closing a leg at every border crossing.
+	FMazeRouteLeg Leg;
+	Leg.Segment = Segments[StartSegment];
+	Leg.StartTile = StartTile;
+	for (int32 i = Nodes.Num() - 2; i >= 0; i--) {
+		const int32 Node = Nodes[i];
+		const int32 Previous = Nodes[i + 1];
+		const int32 StepCost = Scratch.Cost[Node] - Scratch.Cost[Previous];
+		if (NodeSegment(Node) != NodeSegment(Previous)) {
+			Leg.EndTile = NodeTile(Previous);
+			Leg.ExitSide = (EDirection)(Previous % 4);
+			Leg.Cost += StepCost;
+			Route.Legs.Add(Leg);
+
+			Leg = FMazeRouteLeg();
+			Leg.Segment = Segments[NodeSegment(Node)];
+			Leg.StartTile = NodeTile(Node);
+		} else {
+			Leg.Cost += StepCost;
+		}
+	}
+	Leg.EndTile = EndTile;
+	Route.Legs.Add(Leg);
+	Route.TotalCost = Scratch.Cost[EndNode];
+	return true;
+}
+
+bool AMegaMaze::GetRouteLegPath(const FMazeMegaRoute & Route, int32 LegIndex, TArray<FVector> & Path) {
+	if (!Route.Legs.IsValidIndex(LegIndex) || !Route.Legs[LegIndex].Segment) {
+		return false;
+	}
+
+	const FMazeRouteLeg& Leg = Route.Legs[LegIndex];
+	TArray<FIntPair> Tiles;
+	Leg.Segment->FindPathBetweenPoints(Leg.StartTile, Leg.EndTile, Tiles);
+	if (Tiles.Num() == 0) {
+		return false;
+	}
+
+	// The two gap tiles between segments belong to neither grid; the leg that crosses them emits them.
+	if (Leg.ExitSide != EDirection::D_None) {
+		const FIntPair Gap = FMazeTileGrid::Step(Leg.EndTile, Leg.ExitSide);
+		Tiles.Add(Gap);
+		Tiles.Add(FMazeTileGrid::Step(Gap, Leg.ExitSide));
+	}
+
+	for (const FIntPair& Tile : Tiles) {
+		Path.Add(GetTileCenter(Leg.Segment, Tile));
+	}
+	return true;
+}
+
+bool AMegaMaze::FindPathAcrossMaze(FVector StartLocation, FVector EndLocation, TArray<FVector> & Path) {
+	FMazeMegaRoute Route;
+	if (!PlanRoute(StartLocation, EndLocation, Route)) {
+		return false;
+	}
+
+	for (int32 LegIndex = 0; LegIndex < Route.Legs.Num(); LegIndex++) {
+		if (!GetRouteLegPath(Route, LegIndex, Path)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+FVector AMegaMaze::GetTileCenter(const AMazeSegment* Segment, FIntPair Tile) const {
+	const float SegmentTileSize = Segment->GetTileSize();
+	return Segment->GetActorLocation() + FVector(((float)(Tile.x + 1) + 0.5f) * SegmentTileSize, ((float)(Tile.y + 1) + 0.5f) * SegmentTileSize, Segment->GetFloorHeight());
+}
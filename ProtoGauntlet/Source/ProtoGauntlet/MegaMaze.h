@@ -3,8 +3,87 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+#include "MazeSearchScratch.h"
 #include "MegaMaze.generated.h"
 
+/** One stretch of a cross-segment route that stays inside a single segment. */
+USTRUCT(BlueprintType)
+struct FMazeRouteLeg
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Route")
+	class AMazeSegment* Segment;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Route")
+	FIntPair StartTile;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Route")
+	FIntPair EndTile;
+
+	/** Steps from StartTile to EndTile, plus the border crossing into the next leg. */
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Route")
+	int32 Cost;
+
+	/** Side of the segment the route leaves by, or D_None on the last leg. */
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Route")
+	EDirection ExitSide;
+
+	FMazeRouteLeg()
+	{
+		Segment = nullptr;
+		Cost = 0;
+		ExitSide = EDirection::D_None;
+	}
+};
+
+/** A route planned over segment portals; each leg is refined into tiles only when asked for. */
+USTRUCT(BlueprintType)
+struct FMazeMegaRoute
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Route")
+	TArray<FMazeRouteLeg> Legs;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze Route")
+	int32 TotalCost;
+
+	FMazeMegaRoute()
+	{
+		TotalCost = 0;
+	}
+};
+
+UENUM(BlueprintType)
+enum class EMegaMazeBuildStage : uint8
+{
+	MBS_NotStarted		UMETA(DisplayName = "Not Started"),
+	MBS_GeneratingLayouts		UMETA(DisplayName = "Generating Layouts"),
+	MBS_Finalizing		UMETA(DisplayName = "Finalizing"),
+	MBS_Complete		UMETA(DisplayName = "Complete")
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMegaMazeBuiltSignature);
+
+/** Portal to portal costs inside one segment, valid for one layout version. */
+struct FMazeSegmentPortals
+{
+	/** Layout version the costs were measured against; INDEX_NONE until first measured. */
+	int32 LayoutVersion;
+
+	/** Whether each side's middle edge tile is walkable, indexed by EDirection. */
+	bool bOpen[4];
+
+	/** Steps between side portals, INDEX_NONE where unconnected. Indexed From * 4 + To. */
+	int32 Costs[16];
+
+	FMazeSegmentPortals()
+	{
+		LayoutVersion = INDEX_NONE;
+	}
+};
+
 UCLASS()
 class PROTOGAUNTLET_API AMegaMaze : public AActor
 {
@@ -39,20 +118,142 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dimensions")
 	float OuterWallHeight;
 
+	/** Every segment's seed is derived from this one. Zero picks a fresh seed at BeginPlay. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Generation")
+	int32 RandomSeed;
+
+	/** Segments whose walls are spawned per frame once their layouts are ready. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Generation", meta = (ClampMin = "1"))
+	int32 SegmentsFinalizedPerTick;
+
+	/** Broadcast once every segment has been generated and spawned. */
+	UPROPERTY(BlueprintAssignable, Category = "Generation")
+	FMegaMazeBuiltSignature OnMazeBuilt;
+
+	UFUNCTION(BlueprintCallable, Category = "Generation")
+	EMegaMazeBuildStage GetBuildStage();
+
+	/**
+	 * Spawn segment walls only near players and streaming sources. Segments further away keep
+	 * their layout and pathfinding, and remember which walls were lowered, but hold no walls.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	bool bStreamSegmentWalls;
+
+	/** A segment's walls are spawned once a source comes within this distance of its edge. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming", meta = (ClampMin = "0.0"))
+	float StreamInRadius;
+
+	/** Walls are released only once every source is further than this; kept above StreamInRadius. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming", meta = (ClampMin = "0.0"))
+	float StreamOutRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming", meta = (ClampMin = "0.01"))
+	float StreamingUpdateInterval;
+
+	/** Segments whose walls may be spawned per update, nearest first. Releasing is not limited. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming", meta = (ClampMin = "1"))
+	int32 SegmentsMaterializedPerUpdate;
+
+	/** Keeps walls around an actor other than a player pawn, such as an active guardian. */
+	UFUNCTION(BlueprintCallable, Category = "Streaming")
+	void AddStreamingSource(AActor* Source);
+
+	UFUNCTION(BlueprintCallable, Category = "Streaming")
+	void RemoveStreamingSource(AActor* Source);
+
+	UFUNCTION(BlueprintCallable, Category = "Streaming")
+	int32 GetNumMaterializedSegments();
+
+	/** Zero to one across both layout generation and finalizing, for a loading screen. */
+	UFUNCTION(BlueprintCallable, Category = "Generation")
+	float GetBuildProgress();
+
 	// Sets default values for this actor's properties
 	AMegaMaze();
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	// Called every frame
 	virtual void Tick( float DeltaSeconds ) override;
 
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 
+	/** The segment under a world location, or null outside the MegaMaze. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	AMazeSegment* GetSegmentAtLocation(FVector Location);
+
+	/**
+	 * Plans a route between two world locations over the portals joining the segments.
+	 * Only the per-segment legs are returned; no tiles are searched beyond portal costs.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	bool PlanRoute(FVector StartLocation, FVector EndLocation, FMazeMegaRoute & Route);
+
+	/** World-space tile centers for one leg of a planned route, including its border crossing. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	bool GetRouteLegPath(const FMazeMegaRoute & Route, int32 LegIndex, TArray<FVector> & Path);
+
+	/** Plans a route and refines every leg, giving world-space tile centers from start to end. */
+	UFUNCTION(BlueprintCallable, Category = "Pathfinding")
+	bool FindPathAcrossMaze(FVector StartLocation, FVector EndLocation, TArray<FVector> & Path);
+
 	private:
 
+	/** Spawned segments, row-major by segment position. */
+	UPROPERTY()
+	TArray<AMazeSegment*> Segments;
+
+	TArray<FMazeSegmentPortals> SegmentPortals;
+
+	EMegaMazeBuildStage BuildStage;
+
+	/** Layout tasks in flight; EndPlay waits on them so no worker outlives its segment. */
+	FGraphEventArray LayoutTasks;
+
+	FThreadSafeCounter LayoutsBuilt;
+
+	/** Grids the layout tasks build into, one per segment; moved into the segments by FinalizeSegment. */
+	TArray<FMazeTileGrid> PendingLayouts;
+
+	int32 SegmentsFinalized;
+
+	FMazeSearchScratch RouteScratch;
+
+	/** Actors besides player pawns that keep walls streamed in. */
+	TArray<TWeakObjectPtr<AActor>> StreamingSources;
+
+	FTimerHandle StreamingTimer;
+
+	/** Spawns walls for segments a source has come near and releases those every source has left. */
+	void UpdateWallStreaming();
+
+	/** Horizontal distance from Location to the nearest point of a segment, zero inside it. */
+	float GetDistanceToSegment(int32 SegmentIndex, const FVector& Location) const;
+
 	void CalculateValues();
-	
-	
+
+	/** Spawns one segment's actors on the game thread; its layout is already built. */
+	void FinalizeSegment(int32 SegmentIndex);
+
+	/** Segment index under a world location and the tile within it, or INDEX_NONE. */
+	int32 FindSegmentTile(FVector Location, FIntPair& Tile);
+
+	/** Middle edge tile of a segment side. */
+	FIntPair GetPortalTile(int32 SegmentIndex, uint8 Side) const;
+
+	/** Segment across the given side, or INDEX_NONE at the MegaMaze edge. */
+	int32 GetNeighborSegment(int32 SegmentIndex, uint8 Side) const;
+
+	/** Tile position across the whole MegaMaze, borders included, for distance estimates. */
+	FIntPair GetGlobalTile(int32 SegmentIndex, FIntPair Tile) const;
+
+	/** Refreshes a segment's portal costs if its layout changed since they were measured. */
+	const FMazeSegmentPortals& GetSegmentPortals(int32 SegmentIndex);
+
+	/** World position of the center of a segment tile. Tiles just outside the grid are border gaps. */
+	FVector GetTileCenter(const AMazeSegment* Segment, FIntPair Tile) const;
 };
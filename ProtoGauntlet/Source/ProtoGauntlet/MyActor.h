@@ -26,16 +26,43 @@ enum class ETileDesignation : uint8
 	TD_OutOfBounds		UMETA(DisplayName = "Out of Bounds")
 };
 
-USTRUCT(BlueprintType)
-struct FMazeRowData
+UENUM(BlueprintType)
+enum class EPathfindingMode : uint8
 {
-	GENERATED_USTRUCT_BODY()
+	PM_RandomDepthFirst		UMETA(DisplayName = "Random Depth First"),
+	PM_BreadthFirst		UMETA(DisplayName = "Breadth First"),
+	PM_AStar		UMETA(DisplayName = "A*"),
+	PM_JunctionGraph		UMETA(DisplayName = "Junction Graph")
+};
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Row Data")
-	TArray<ETileDesignation> Column;
+UENUM(BlueprintType)
+enum class EMazeGenerationAlgorithm : uint8
+{
+	MGA_RecursiveBacktracker		UMETA(DisplayName = "Recursive Backtracker"),
+	MGA_Eller		UMETA(DisplayName = "Eller's Algorithm")
+};
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Maze Row Data")
-	TArray<AMazeWall*> ColumnWallRef;
+UENUM(BlueprintType)
+enum class EShapeshiftMode : uint8
+{
+	SM_Regenerate		UMETA(DisplayName = "Regenerate"),
+	SM_EdgeSwaps		UMETA(DisplayName = "Edge Swaps")
+};
+
+UENUM(BlueprintType)
+enum class EMazeWallCurve : uint8
+{
+	WC_Linear		UMETA(DisplayName = "Linear"),
+	WC_Sine		UMETA(DisplayName = "Sine"),
+	WC_RisingSine		UMETA(DisplayName = "Rising Sine")
+};
+
+UENUM(BlueprintType)
+enum class EMazeWallAction : uint8
+{
+	WA_Lower		UMETA(DisplayName = "Lower"),
+	WA_Raise		UMETA(DisplayName = "Raise"),
+	WA_Marker		UMETA(DisplayName = "Marker")
 };
 
 USTRUCT(BlueprintType)
@@ -66,6 +93,53 @@ struct FIntPair
 	}
 };
 
+USTRUCT(BlueprintType)
+struct FMazePathRequest
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path Request")
+	FIntPair StartPoint;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path Request")
+	FIntPair EndPoint;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path Request")
+	EDirection StartDirection;
+
+	FMazePathRequest()
+	{
+		StartDirection = EDirection::D_None;
+	}
+
+	FMazePathRequest(FIntPair InStartPoint, FIntPair InEndPoint, EDirection InStartDirection)
+	{
+		StartPoint = InStartPoint;
+		EndPoint = InEndPoint;
+		StartDirection = InStartDirection;
+	}
+};
+
+/** Paths for a batch of requests, packed into one buffer. */
+USTRUCT(BlueprintType)
+struct FMazePathBatchResult
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Every path back to back, each from start to end inclusive. */
+	UPROPERTY(BlueprintReadOnly, Category = "Path Batch")
+	TArray<FIntPair> Tiles;
+
+	/** Request i's path is Tiles[Offsets[i]] up to Tiles[Offsets[i + 1]]; empty if none was found. */
+	UPROPERTY(BlueprintReadOnly, Category = "Path Batch")
+	TArray<int32> Offsets;
+
+	int32 NumPaths() const
+	{
+		return Offsets.Num() > 0 ? Offsets.Num() - 1 : 0;
+	}
+};
+
 UCLASS()
 class PROTOGAUNTLET_API AMyActor : public AActor
 {
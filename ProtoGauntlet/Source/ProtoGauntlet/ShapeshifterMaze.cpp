@@ -2,20 +2,20 @@
 
 #include "ProtoGauntlet.h"
 #include "ShapeshifterMaze.h"
+#include "MazeEdgeSwap.h"
+
+namespace
+{
+	/** Stream sequence for back buffer layouts, apart from the segment's own generation stream. */
+	const uint64 ShapeshiftSequence = 2;
+}
 
 void AShapeshifterMaze::SpawnWalls() {
-	AMazeWall* CurrentWall;
 	float VisibilityOffset = 10.1f; // Keeps the ground from clipping with lowered walls
 	for (int y = 0; y < MazeLengthInTiles; y++) {
-		Row[y].ColumnWallRef.SetNum(MazeLengthInTiles);
 		for (int x = 0; x < MazeLengthInTiles; x++) {
 			if (y % 2 == 1 || x % 2 == 1) {
-				CurrentWall = Cast<AMazeWall>(GetWorld()->SpawnActor(WallClass));
-				if (CurrentWall) {
-					CurrentWall->SetActorLocation(GetActorLocation() + FVector((float)(x + 1) * TileSize, (float)(y + 1) * TileSize, FloorHeight - VisibilityOffset ));
-					CurrentWall->SetActorScale3D(FVector(TileSize / 100.f, TileSize / 100.f, InnerWallHeight / 100.f));
-					Row[y].ColumnWallRef[x] = CurrentWall;
-				}
+				SpawnWallAt(y, x, FVector((float)(x + 1) * TileSize, (float)(y + 1) * TileSize, FloorHeight - VisibilityOffset));
 			}
 		}
 	}
@@ -26,6 +26,9 @@ void AShapeshifterMaze::SpawnWalls() {
 void AShapeshifterMaze::BeginPlay() {
 	Super::BeginPlay();
 
+	ShapeshiftStream.Initialize((uint32)RandomSeed, ShapeshiftSequence);
+	PrepareNextLayout();
+
 	PathfindingActive = false;
 	FTimerHandle ShapeshiftTimer;
 	GetWorldTimerManager().SetTimer(ShapeshiftTimer, this, &AShapeshifterMaze::Shapeshift, ShapeshiftDelay, false);
@@ -34,19 +37,26 @@ void AShapeshifterMaze::BeginPlay() {
 AShapeshifterMaze::AShapeshifterMaze() {
 	ShapeshiftDelay = 5.f;
 	PostDepowerDelay = 5.f;
+	ShapeshiftMode = EShapeshiftMode::SM_Regenerate;
+	EdgeSwapsPerShapeshift = 6;
+}
+
+void AShapeshifterMaze::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (NextLayoutTask.IsValid() && !NextLayoutTask->IsComplete()) {
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(NextLayoutTask, ENamedThreads::GameThread);
+	}
+	NextLayoutTask = nullptr;
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AShapeshifterMaze::RaiseAllWalls() {
-	AMazeWall* CurrentWall;
-	float VisibilityOffset = 10.1f; // Keeps the ground from clipping with lowered walls
+	WaitForNextLayout();
 	for (int y = 0; y < MazeLengthInTiles; y++) {
 		for (int x = 0; x < MazeLengthInTiles; x++) {
 			if (y % 2 == 1 || x % 2 == 1) {
-				CurrentWall = Row[y].ColumnWallRef[x];
-				if (CurrentWall) {
-					if (CurrentWall->LowerEnabled == false) {
-						CurrentWall->Raise();
-					}
+				if (NextGrid.Get(y, x) != ETileDesignation::TD_Path && HasWallAt(y, x) && IsWallLoweredAt(y, x)) {
+					RaiseWallAt(y, x);
 				}
 			}
 		}
@@ -55,90 +65,79 @@ void AShapeshifterMaze::RaiseAllWalls() {
 }
 
 void AShapeshifterMaze::ShuffleMazeLayout() {
-	for (int y = 0; y < MazeLengthInTiles; y++) {
-		for (int x = 0; x < MazeLengthInTiles; x++) {
-			if (y % 2 == 0 && x % 2 == 0) {
-				Row[y].Column[x] = ETileDesignation::TD_Cell;
-			}
-			else{
-				Row[y].Column[x] = ETileDesignation::TD_Wall;
-			}
-		}
-	}
-
-	TArray<FIntPair> TileStack;
-	TArray<FIntPair> ValidNeighbors;
-	FIntPair StackHead;
-
-	TileStack.Push(StackHead);
-	Row[0].Column[0] = ETileDesignation::TD_Path;
-
-	while (TileStack.Num()) {
-		ValidNeighbors.SetNum(0);
+	SwapInNextLayout();
+}
 
-		// Upper Neighbor
-		if (StackHead.y - 2 >= 0 && Row[StackHead.y - 2].Column[StackHead.x] == ETileDesignation::TD_Cell) {
-			ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y - 2));
-		}
+int32 AShapeshifterMaze::ApplyNextLayout() {
+	WaitForNextLayout();
+	PathfindingActive = false;
 
-		// Lower Neighbor
-		if (StackHead.y + 2 < MazeLengthInTiles && Row[StackHead.y + 2].Column[StackHead.x] == ETileDesignation::TD_Cell) {
-			ValidNeighbors.Add(FIntPair(StackHead.x, StackHead.y + 2));
+	int32 WallsChanged = 0;
+	for (int32 TileIndex = 0; TileIndex < Grid.Num(); TileIndex++) {
+		if (Grid.Tiles[TileIndex] == NextGrid.Tiles[TileIndex]) {
+			continue;
 		}
 
-		// Left Neighbor
-		if (StackHead.x - 2 >= 0 && Row[StackHead.y].Column[StackHead.x - 2] == ETileDesignation::TD_Cell) {
-			ValidNeighbors.Add(FIntPair(StackHead.x - 2, StackHead.y));
+		const int32 TileRow = TileIndex / Grid.Width;
+		const int32 TileColumn = TileIndex % Grid.Width;
+		if (!HasWallAt(TileRow, TileColumn)) {
+			continue;
 		}
 
-		// Right Neighbor
-		if (StackHead.x + 2 < MazeLengthInTiles && Row[StackHead.y].Column[StackHead.x + 2] == ETileDesignation::TD_Cell) {
-			ValidNeighbors.Add(FIntPair(StackHead.x + 2, StackHead.y));
+		if (NextGrid.Tiles[TileIndex] == ETileDesignation::TD_Path) {
+			LowerWallAt(TileRow, TileColumn);
+			WallsChanged++;
+		} else if (IsWallLoweredAt(TileRow, TileColumn)) {
+			RaiseWallAt(TileRow, TileColumn);
+			WallsChanged++;
 		}
+	}
 
-		if (ValidNeighbors.Num() != 0) {
-			// Choose random valid neighbor
-			StackHead = ValidNeighbors[FMath::RandRange(0, ValidNeighbors.Num() - 1)];
-
-			if (StackHead.y + 2 == TileStack.Last().y) {
-				Row[StackHead.y + 1].Column[StackHead.x] = ETileDesignation::TD_Path;
-
-			}
-			else if (StackHead.y - 2 == TileStack.Last().y) {
-				Row[StackHead.y - 1].Column[StackHead.x] = ETileDesignation::TD_Path;
-
-			}
-			else if (StackHead.x + 2 == TileStack.Last().x) {
-				Row[StackHead.y].Column[StackHead.x + 1] = ETileDesignation::TD_Path;
-
-			}
-			else {
-				Row[StackHead.y].Column[StackHead.x - 1] = ETileDesignation::TD_Path;
-
-			}
+	SwapInNextLayout();
+	PathfindingActive = true;
+	return WallsChanged;
+}
 
-			Row[StackHead.y].Column[StackHead.x] = ETileDesignation::TD_Path;
-			TileStack.Push(StackHead);
-		}
-		else {
-			TileStack.Pop();
-			if (TileStack.Num() != 0) {
-				StackHead = TileStack.Last();
-			}
-		}
+void AShapeshifterMaze::PrepareNextLayout() {
+	NextGrid.Width = Grid.Width;
+	NextGrid.Height = Grid.Height;
+	if (ShapeshiftMode == EShapeshiftMode::SM_EdgeSwaps) {
+		// Mutations start from the live layout, copied now while only the game thread touches it.
+		NextGrid.Tiles = Grid.Tiles;
+		const int32 NumSwaps = FMath::Max(EdgeSwapsPerShapeshift, 1);
+		NextLayoutTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this, NumSwaps]() {
+			FMazeEdgeSwap::Apply(NextGrid, NumSwaps, ShapeshiftStream, ShapeshiftScratch);
+		}, TStatId(), nullptr, ENamedThreads::AnyThread);
+	} else {
+		NextGrid.Tiles.SetNumUninitialized(Grid.Num());
+		NextLayoutTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this]() {
+			GenerateLayout(NextGrid, ShapeshiftStream);
+		}, TStatId(), nullptr, ENamedThreads::AnyThread);
+	}
+}
 
+void AShapeshifterMaze::WaitForNextLayout() {
+	if (!NextLayoutTask.IsValid()) {
+		PrepareNextLayout();
+	}
+	if (!NextLayoutTask->IsComplete()) {
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(NextLayoutTask, ENamedThreads::GameThread);
 	}
 }
 
+void AShapeshifterMaze::SwapInNextLayout() {
+	WaitForNextLayout();
+	Swap(Grid.Tiles, NextGrid.Tiles);
+	NextLayoutTask = nullptr;
+	RebuildLayoutCaches();
+	PrepareNextLayout();
+}
+
 void AShapeshifterMaze::LowerInactiveWalls() {
-	AMazeWall* CurrentWall;
 	for (int y = 0; y < MazeLengthInTiles; y++) {
 		for (int x = 0; x < MazeLengthInTiles; x++) {
-			CurrentWall = Row[y].ColumnWallRef[x];
-			if (CurrentWall) {
-				if (Row[y].Column[x] == ETileDesignation::TD_Path) {
-					CurrentWall->Lower();
-				}
+			if (Grid.Get(y, x) == ETileDesignation::TD_Path && HasWallAt(y, x) && !IsWallLoweredAt(y, x)) {
+				LowerWallAt(y, x);
 			}
 		}
 
@@ -21,14 +21,35 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shapeshift")
 	float PostDepowerDelay;
 
+	/**
+	 * Regenerate builds a whole new maze; Edge Swaps edits the current one by a bounded number
+	 * of swaps. Changes apply from the next layout prepared, one shapeshift later.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shapeshift")
+	EShapeshiftMode ShapeshiftMode;
+
+	/** Swaps per shapeshift in Edge Swaps mode. Each moves at most two walls. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shapeshift", meta = (ClampMin = "1"))
+	int32 EdgeSwapsPerShapeshift;
+
 	virtual void BeginPlay() override;
 
+	/** Raises the lowered walls that close in the prepared next layout. Walls that stay open are left down. */
 	UFUNCTION(BlueprintCallable, Category = "Shapeshift")
 	void RaiseAllWalls();
 
+	/** Swaps in the prepared next layout with no wall changes; run between RaiseAllWalls and LowerInactiveWalls. */
 	UFUNCTION(BlueprintCallable, Category = "Shapeshift")
 	void ShuffleMazeLayout();
 
+	/**
+	 * Swaps in the prepared next layout, raising or lowering only the walls whose tile
+	 * changes. Returns how many walls were told to move.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Shapeshift")
+	int32 ApplyNextLayout();
+
+	/** Lowers walls standing on path tiles. Walls already down are skipped. */
 	UFUNCTION(BlueprintCallable, Category = "Shapeshift")
 	void LowerInactiveWalls();
 
@@ -39,6 +60,28 @@ protected:
 	void Shapeshift();
 
 	AShapeshifterMaze();
-	
-	
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	/** Back buffer, tiles only. Written by the layout task, read on the game thread only once it completes. */
+	FMazeTileGrid NextGrid;
+
+	FGraphEventRef NextLayoutTask;
+
+	/** Drives back buffer generation; only the layout task draws from it. */
+	FMazeRandomStream ShapeshiftStream;
+
+	/** Loop searches for edge swaps, used by the layout task only. */
+	FMazeSearchScratch ShapeshiftScratch;
+
+	/** Starts generating the next layout on a worker thread. */
+	void PrepareNextLayout();
+
+	/** Blocks until the back buffer holds a complete layout. */
+	void WaitForNextLayout();
+
+	/** Makes the back buffer the live layout and starts preparing the one after. */
+	void SwapInNextLayout();
 };
@@ -3,41 +3,20 @@
 #include "ProtoGauntlet.h"
 #include "SpiralLabyrinth.h"
 
-void ASpiralLabyrinth::CreateMazeLayout() {
-	FMazeRowData CellRow;
-	FMazeRowData WallRow;
-
-	WallRow.Column.Init(ETileDesignation::TD_Wall, MazeLengthInTiles);
-	for (int32 index = 0; index < MazeLengthInTiles; index++) {
-		if (index % 2 == 1) {
-			CellRow.Column.Add(ETileDesignation::TD_Wall);
-		}
-		else {
-			CellRow.Column.Add(ETileDesignation::TD_Cell);
-		}
-
-	}
-
-	for (int32 index = 0; index < MazeLengthInTiles; index++) {
-		if (index % 2 == 1) {
-			Row.Add(WallRow);
-		}
-		else {
-			Row.Add(CellRow);
-		}
-	}
+void ASpiralLabyrinth::CreateMazeLayout(FMazeTileGrid& Target) {
+	Target.InitCells(MazeLengthInTiles, MazeLengthInTiles);
 	
 	TArray<FIntPair> ValidNeighbors;
 	FIntPair StackHead;
-	Row[0].Column[0] = ETileDesignation::TD_Path;
+	Target.Set(0, 0, ETileDesignation::TD_Path);
 	int32 CellNum = (MazeLengthInTiles / 2 + 1) * (MazeLengthInTiles / 2 + 1) - 1;
 	EDirection PathDirection = EDirection::D_East;
 	
 	while (CellNum > 0) {
 		if (PathDirection == EDirection::D_East){
-			if (GetTileDesignationAt(StackHead.y, StackHead.x + 2) != ETileDesignation::TD_OutOfBounds && GetTileDesignationAt(StackHead.y, StackHead.x + 2 ) != ETileDesignation::TD_Path) {
-				Row[StackHead.y].Column[StackHead.x + 1] = ETileDesignation::TD_Path;
-				Row[StackHead.y].Column[StackHead.x + 2] = ETileDesignation::TD_Path;
+			if (Target.IsValid(StackHead.y, StackHead.x + 2) && Target.Get(StackHead.y, StackHead.x + 2) != ETileDesignation::TD_Path) {
+				Target.Set(StackHead.y, StackHead.x + 1, ETileDesignation::TD_Path);
+				Target.Set(StackHead.y, StackHead.x + 2, ETileDesignation::TD_Path);
 				CellNum -= 1;
 				StackHead = FIntPair(StackHead.x + 2, StackHead.y);
 			} else {
@@ -46,9 +25,9 @@ void ASpiralLabyrinth::CreateMazeLayout() {
 		}
 
 		if (PathDirection == EDirection::D_South){
-			if (GetTileDesignationAt(StackHead.y + 2, StackHead.x) != ETileDesignation::TD_OutOfBounds && GetTileDesignationAt(StackHead.y + 2, StackHead.x) != ETileDesignation::TD_Path) {
-				Row[StackHead.y + 1].Column[StackHead.x] = ETileDesignation::TD_Path;
-				Row[StackHead.y + 2].Column[StackHead.x] = ETileDesignation::TD_Path;
+			if (Target.IsValid(StackHead.y + 2, StackHead.x) && Target.Get(StackHead.y + 2, StackHead.x) != ETileDesignation::TD_Path) {
+				Target.Set(StackHead.y + 1, StackHead.x, ETileDesignation::TD_Path);
+				Target.Set(StackHead.y + 2, StackHead.x, ETileDesignation::TD_Path);
 				CellNum -= 1;
 				StackHead = FIntPair(StackHead.x, StackHead.y + 2);
 			}
@@ -58,9 +37,9 @@ void ASpiralLabyrinth::CreateMazeLayout() {
 		}
 
 		if (PathDirection == EDirection::D_West){
-			if (GetTileDesignationAt(StackHead.y, StackHead.x - 2) != ETileDesignation::TD_OutOfBounds && GetTileDesignationAt(StackHead.y, StackHead.x - 2) != ETileDesignation::TD_Path) {
-				Row[StackHead.y].Column[StackHead.x - 1] = ETileDesignation::TD_Path;
-				Row[StackHead.y].Column[StackHead.x - 2] = ETileDesignation::TD_Path;
+			if (Target.IsValid(StackHead.y, StackHead.x - 2) && Target.Get(StackHead.y, StackHead.x - 2) != ETileDesignation::TD_Path) {
+				Target.Set(StackHead.y, StackHead.x - 1, ETileDesignation::TD_Path);
+				Target.Set(StackHead.y, StackHead.x - 2, ETileDesignation::TD_Path);
 				CellNum -= 1;
 				StackHead = FIntPair(StackHead.x - 2, StackHead.y);
 			} else {
@@ -69,9 +48,9 @@ void ASpiralLabyrinth::CreateMazeLayout() {
 		}
 
 		if (PathDirection == EDirection::D_North){
-			if (GetTileDesignationAt(StackHead.y - 2, StackHead.x) != ETileDesignation::TD_OutOfBounds && GetTileDesignationAt(StackHead.y - 2, StackHead.x) != ETileDesignation::TD_Path) {
-				Row[StackHead.y - 1].Column[StackHead.x] = ETileDesignation::TD_Path;
-				Row[StackHead.y - 2].Column[StackHead.x] = ETileDesignation::TD_Path;
+			if (Target.IsValid(StackHead.y - 2, StackHead.x) && Target.Get(StackHead.y - 2, StackHead.x) != ETileDesignation::TD_Path) {
+				Target.Set(StackHead.y - 1, StackHead.x, ETileDesignation::TD_Path);
+				Target.Set(StackHead.y - 2, StackHead.x, ETileDesignation::TD_Path);
 				CellNum -= 1;
 				StackHead = FIntPair(StackHead.x, StackHead.y - 2);
 			}
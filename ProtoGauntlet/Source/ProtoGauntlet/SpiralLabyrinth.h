@@ -15,7 +15,7 @@ class PROTOGAUNTLET_API ASpiralLabyrinth : public AMazeSegment
 
 protected:
 
-	void CreateMazeLayout();
+	void CreateMazeLayout(FMazeTileGrid& Target);
 	
 	
 	